@@ -0,0 +1,33 @@
+#ifndef BUILD_ID_H
+#define BUILD_ID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class BuildIdKind {
+    NONE,
+    FAST,  // 64-bit xxHash
+    SHA1,
+    UUID   // Random, not derived from the contents
+};
+
+bool parseBuildIdKind(const std::string& name, BuildIdKind& kind);
+
+// Computes the .note.gnu.build-id descriptor for an output image. The image
+// is hashed in fixed-size chunks on multiple threads and the chunk digests
+// are hashed again, so the result does not depend on the thread count.
+class BuildIdHasher {
+public:
+    static const size_t CHUNK_SIZE = 1 << 20;
+
+    static size_t hashSize(BuildIdKind kind);
+    void compute(BuildIdKind kind, const char* data, size_t size, std::vector<uint8_t>& id);
+
+    // Plain one-shot digests used for the leaf and root hashes
+    static uint64_t xxHash64(const uint8_t* data, size_t size);
+    static void sha1(const uint8_t* data, size_t size, uint8_t digest[20]);
+};
+
+#endif // BUILD_ID_H
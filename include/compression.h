@@ -0,0 +1,36 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <string>
+#include <vector>
+#include "object_file.h"
+#include "layout.h"
+
+enum class DebugCompression {
+    NONE,
+    ZLIB,
+    ZSTD
+};
+
+bool parseDebugCompression(const std::string& name, DebugCompression& compression);
+bool isDebugCompressionAvailable(DebugCompression compression);
+
+// Handles SHF_COMPRESSED debug sections. Inputs (including GNU-style
+// .zdebug_* sections, renamed back to .debug_*) are inflated and outputs are
+// deflated in independent chunks spread across threads.
+class SectionCompressor {
+public:
+    static const size_t CHUNK_SIZE = 1 << 20;
+    static const uint64_t MAX_SECTION_SIZE = 1ULL << 32;  // Largest uncompressed input section accepted
+    static const uint64_t MAX_DEFLATE_RATIO = 1032;       // Deflate cannot expand further than this
+
+    bool decompressInputs(std::vector<ObjectFile>& objects);
+    void compressOutputs(const std::vector<ObjectFile>& objects, Layout& layout, DebugCompression compression);
+
+private:
+    bool decompressSection(InputSection& section, const std::string& filePath);
+    bool compressZlib(const std::vector<char>& contents, std::vector<char>& compressed);
+    bool compressZstd(const std::vector<char>& contents, std::vector<char>& compressed);
+};
+
+#endif // COMPRESSION_H
@@ -35,6 +35,18 @@ struct ELFSectionHeader {
     uint64_t sh_entsize;    // Entry size if section holds a table
 };
 
+// ELF Program Header
+struct ELFProgramHeader {
+    uint32_t p_type;        // Segment type
+    uint32_t p_flags;       // Segment flags
+    uint64_t p_offset;      // Offset in file
+    uint64_t p_vaddr;       // Virtual address in memory
+    uint64_t p_paddr;       // Physical address (unused)
+    uint64_t p_filesz;      // Size of segment in file
+    uint64_t p_memsz;       // Size of segment in memory
+    uint64_t p_align;       // Segment alignment
+};
+
 // ELF Symbol Entry
 struct Elf64_Sym {
     uint32_t st_name;  // Symbol name (index into string table)
@@ -58,6 +70,54 @@ struct ELFRelocationA {
     int64_t r_addend;       // Constant addend used to compute value
 };
 
+// Section types
+#define SHT_NULL          0
+#define SHT_PROGBITS      1
+#define SHT_SYMTAB        2
+#define SHT_STRTAB        3
+#define SHT_RELA          4
+#define SHT_NOTE          7
+#define SHT_NOBITS        8
+#define SHT_REL           9
+
+// Section flags
+#define SHF_WRITE         0x1
+#define SHF_ALLOC         0x2
+#define SHF_EXECINSTR     0x4
+#define SHF_GROUP         0x200
+#define SHF_COMPRESSED    0x800
+
+// Compression header at the start of an SHF_COMPRESSED section
+struct Elf64_Chdr {
+    uint32_t ch_type;       // Compression algorithm
+    uint32_t ch_reserved;
+    uint64_t ch_size;       // Uncompressed size
+    uint64_t ch_addralign;  // Uncompressed alignment
+};
+
+#define ELFCOMPRESS_ZLIB  1
+#define ELFCOMPRESS_ZSTD  2
+
+// Special section indices
+#define SHN_UNDEF         0
+#define SHN_LORESERVE     0xFF00
+
+// Symbol type macros
+#define ELF64_ST_TYPE(i)  ((i) & 0xF)
+#define STT_FUNC          2
+#define STT_SECTION       3
+#define STT_FILE          4
+
+// Program header types and flags
+#define PT_LOAD           1
+#define PT_NOTE           4
+#define PF_X              0x1
+#define PF_W              0x2
+#define PF_R              0x4
+
+// Note types
+#define NT_GNU_BUILD_ID   3
+
 // Relocation type macros (for simplicity, we're focusing on 64-bit ELF)
 #define ELF64_R_SYM(i)    ((i) >> 32)          // Extract symbol index
 #define ELF64_R_TYPE(i)   ((i) & 0xFFFFFFFF)   // Extract relocation type
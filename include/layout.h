@@ -0,0 +1,58 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "object_file.h"
+#include "symbol_table.h"
+
+// Position of one input section inside an output section
+struct SectionPlacement {
+    size_t objectIndex;   // Index of the input object file
+    size_t sectionIndex;  // Index into ObjectFile::sections
+    uint64_t offset;      // Offset within the output section
+};
+
+// An output section built by concatenating input sections of the same kind
+struct OutputSection {
+    std::string name;
+    uint32_t type;
+    uint64_t flags;
+    uint64_t addr;        // Virtual address (0 for non-allocated sections)
+    uint64_t fileOffset;  // Offset in the output image
+    uint64_t size;        // Uncompressed size
+    uint64_t addralign;
+    std::vector<SectionPlacement> inputs;
+    std::vector<char> compressedData;  // Chdr and payload when SHF_COMPRESSED is set
+};
+
+class Layout {
+public:
+    static const uint64_t IMAGE_BASE = 0x400000;
+    static const uint64_t SEGMENT_ALIGN = 0x1000;
+
+    void setSymbolOrder(const std::vector<std::string>& symbolOrder, const SymbolTable& symbolTable,
+                        const std::vector<ObjectFile>& objects);
+    void assign(const std::vector<ObjectFile>& objects);
+    void setCompressedContents(size_t sectionIndex, std::vector<char>& contents);
+    const std::vector<OutputSection>& getOutputSections() const;
+    uint64_t getImageSize() const;
+    bool getInputSectionAddress(size_t objectIndex, size_t sectionIndex, uint64_t& address) const;
+    uint64_t getSymbolAddress(const SymbolInfo& symbol) const;
+
+    static std::string outputSectionName(const std::string& inputName);
+    static bool readSymbolOrderingFile(const std::string& filePath, std::vector<std::string>& symbolOrder);
+
+private:
+    void assignFileOffsets();
+
+    std::vector<OutputSection> outputSections;
+    std::map<std::pair<size_t, size_t>, size_t> sectionPriority;  // (object, section) -> position in ordering file
+    std::vector<std::vector<int64_t> > inputAddresses;  // [object][section], -1 if not placed
+    uint64_t imageSize = 0;
+};
+
+#endif // LAYOUT_H
@@ -0,0 +1,28 @@
+#ifndef LINK_SERVER_H
+#define LINK_SERVER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "object_cache.h"
+
+// Keeps parsed objects in memory between links and serves link requests
+// over a Unix domain socket. A request is the client's working directory
+// followed by its command line arguments, each NUL-terminated, ending with
+// an empty field; the reply is "ok\n" or "error\n" followed by the warnings
+// and errors the link wrote to std::cerr.
+class LinkServer {
+public:
+    static const int REQUEST_TIMEOUT_SECONDS = 10;  // Per read or write on a client connection
+    static const size_t MAX_REQUEST_SIZE = 1 << 20;
+
+    bool serve(const std::string& socketPath);
+    static int sendRequest(const std::string& socketPath, const std::vector<std::string>& args);
+
+private:
+    bool handleRequest(const std::vector<std::string>& fields);
+
+    ObjectCache objectCache;
+};
+
+#endif // LINK_SERVER_H
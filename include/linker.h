@@ -3,10 +3,35 @@
 
 #include <vector>
 #include <string>
+#include "compression.h"
+#include "build_id.h"
+
+class ObjectCache;
+
+struct LinkerOptions {
+    std::string outputFile = "a.out";
+    std::string mapFile;      // -Map=<file>
+    std::string jsonMapFile;  // --json-map=<file>
+    std::string symbolOrderingFile;  // --symbol-ordering-file=<file>
+    DebugCompression compressDebugSections = DebugCompression::NONE;  // --compress-debug-sections=zlib|zstd|none
+    BuildIdKind buildId = BuildIdKind::NONE;  // --build-id[=fast|sha1|uuid|none]
+    std::string serveSocket;    // --serve <socket>
+    std::string connectSocket;  // --connect <socket>
+};
+
+// Splits command line arguments into options and input files
+bool parseLinkerArguments(const std::vector<std::string>& args, LinkerOptions& options, std::vector<std::string>& inputFiles);
+
+// Drops inputs whose object format is not recognized; used by both the CLI and the link server
+std::vector<std::string> selectObjectFiles(const std::vector<std::string>& inputFiles);
 
 class Linker {
 public:
-    void link(const std::vector<std::string>& objectFiles);
+    void setObjectCache(ObjectCache* cache);
+    bool link(const std::vector<std::string>& objectFiles, const LinkerOptions& options = LinkerOptions());
+
+private:
+    ObjectCache* objectCache = nullptr;  // Parsed objects reused across links (server mode)
 };
 
 #endif // LINKER_H
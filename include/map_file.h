@@ -0,0 +1,19 @@
+#ifndef MAP_FILE_H
+#define MAP_FILE_H
+
+#include <string>
+#include <vector>
+#include "object_file.h"
+#include "layout.h"
+#include "symbol_table.h"
+
+// Writes the link map: output section -> input file section -> symbol
+class MapFile {
+public:
+    bool writeText(const std::string& mapFile, const std::vector<ObjectFile>& objects,
+                   const Layout& layout, const SymbolTable& symbolTable);
+    bool writeJSON(const std::string& mapFile, const std::vector<ObjectFile>& objects,
+                   const Layout& layout, const SymbolTable& symbolTable);
+};
+
+#endif // MAP_FILE_H
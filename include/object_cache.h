@@ -0,0 +1,46 @@
+#ifndef OBJECT_CACHE_H
+#define OBJECT_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "object_file.h"
+#include "symbol_table.h"
+
+// Modification time and size identifying one version of a file
+struct FileStamp {
+    int64_t mtime;
+    int64_t mtimeNsec;
+    uint64_t size;
+
+    bool operator==(const FileStamp& other) const {
+        return mtime == other.mtime && mtimeNsec == other.mtimeNsec && size == other.size;
+    }
+};
+
+// Parsed object kept between links; valid while the file's stamp is unchanged
+struct CachedObject {
+    FileStamp stamp;
+    ObjectFile object;  // Debug sections already decompressed; contents are shared with every link that reuses it
+    std::vector<SymbolInfo> symbols;  // objectIndex is not meaningful here
+    uint64_t lastUse;  // Value of the cache's use counter when last stored or found
+};
+
+class ObjectCache {
+public:
+    static const size_t MAX_ENTRIES = 4096;  // Least recently used entries are evicted past this
+
+    static bool readStamp(const std::string& filePath, FileStamp& stamp);
+
+    const CachedObject* lookup(const std::string& filePath);
+    void store(const std::string& filePath, const FileStamp& stamp, const ObjectFile& object,
+               const std::vector<SymbolInfo>& symbols);
+    void prune();  // Drops entries whose file was deleted or changed
+
+private:
+    std::unordered_map<std::string, CachedObject> entries;
+    uint64_t useCounter = 0;
+};
+
+#endif // OBJECT_CACHE_H
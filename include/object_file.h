@@ -0,0 +1,33 @@
+#ifndef OBJECT_FILE_H
+#define OBJECT_FILE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "platform_detector.h"
+
+// A section read from an input object file
+struct InputSection {
+    std::string name;       // Section name
+    uint32_t type;          // Section type (SHT_* for ELF)
+    uint64_t flags;         // Section flags (SHF_* for ELF)
+    uint64_t size;          // Size of section
+    uint64_t addralign;     // Section alignment
+    std::shared_ptr<const std::vector<char> > data;  // Contents, shared between copies (null for NOBITS)
+
+    const std::vector<char>& bytes() const {
+        static const std::vector<char> empty;
+        return data ? *data : empty;
+    }
+};
+
+// Parsed contents of one input object file
+struct ObjectFile {
+    std::string path;
+    Platform platform;
+    uint16_t machine;                   // e_machine / COFF Machine
+    std::vector<InputSection> sections; // Indexed by section header index
+};
+
+#endif // OBJECT_FILE_H
@@ -0,0 +1,28 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <string>
+#include <vector>
+#include "object_file.h"
+#include "layout.h"
+#include "symbol_table.h"
+#include "build_id.h"
+
+class OutputWriter {
+public:
+    static const char* BUILD_ID_SECTION;
+
+    void setBuildId(BuildIdKind kind);
+    bool write(const std::string& outputFile, const std::vector<ObjectFile>& objects,
+               const Layout& layout, const SymbolTable& symbolTable);
+
+private:
+    void buildImage(const std::vector<ObjectFile>& objects, const Layout& layout,
+                    const SymbolTable& symbolTable, std::vector<char>& image);
+    bool writeBuildId(const Layout& layout, std::vector<char>& image);
+    bool writeFile(const std::string& outputFile, const std::vector<char>& image);
+
+    BuildIdKind buildId = BuildIdKind::NONE;
+};
+
+#endif // OUTPUT_WRITER_H
@@ -0,0 +1,16 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+// Runs task(i) for every i in [0, count) on up to hardware_concurrency threads.
+// Tasks must be independent; the call returns once all of them have finished.
+// If a task throws, the first exception is rethrown on the calling thread
+// after every worker has stopped.
+void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+// Caps the number of threads parallelFor uses; 0 restores hardware_concurrency
+void setParallelThreadCount(size_t threadCount);
+
+#endif // PARALLEL_H
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include "symbol_table.h"
+#include "object_file.h"
 #include "platform_detector.h"
 #include "elf_structures.h"
 #include "coff_structures.h"
@@ -14,6 +15,9 @@ public:
     void parseCOFFHeader(const std::string& filePath, COFFHeader& coffHeader);
     void parseELFHeader(const std::string& filePath, ELFHeader& elfHeader);
     void parseELFSections(const std::string& filePath, std::vector<ELFSectionHeader>& sectionHeaders);
+    bool parseObject(const std::string& filePath, Platform platform, size_t objectIndex, ObjectFile& object, SymbolTable& symbolTable);
+    bool parseELFObject(const std::string& filePath, size_t objectIndex, ObjectFile& object, SymbolTable& symbolTable);
+    bool parseCOFFObject(const std::string& filePath, size_t objectIndex, ObjectFile& object, SymbolTable& symbolTable);
 };
 
 #endif // PARSER_H
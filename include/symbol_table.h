@@ -1,16 +1,34 @@
 #ifndef SYMBOL_TABLE_H
 #define SYMBOL_TABLE_H
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+// A symbol together with the input section that defines it
+struct SymbolInfo {
+    std::string name;
+    size_t objectIndex;   // Index of the defining object file
+    int sectionIndex;     // Index into ObjectFile::sections, -1 if undefined/absolute
+    uint64_t value;       // Offset within the section
+    uint64_t size;        // Size of the symbol
+    bool isFunction;
+};
 
 class SymbolTable {
 private:
     std::unordered_map<std::string, int> table;
+    std::vector<SymbolInfo> symbols;
+    std::unordered_map<std::string, std::vector<size_t> > definitions; // Name -> defining entries in symbols
 
 public:
     void addSymbol(const std::string& name, int address);
+    void addSymbol(const SymbolInfo& symbol);
     int getAddress(const std::string& name);
+    const SymbolInfo* findSymbol(const std::string& name) const;
+    std::vector<const SymbolInfo*> findDefinitions(const std::string& name) const;
+    const std::vector<SymbolInfo>& getSymbols() const;
 };
 
 #endif // SYMBOL_TABLE_H
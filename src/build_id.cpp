@@ -0,0 +1,235 @@
+#include "build_id.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+const size_t BuildIdHasher::CHUNK_SIZE;
+
+bool parseBuildIdKind(const std::string& name, BuildIdKind& kind) {
+    if (name == "none") {
+        kind = BuildIdKind::NONE;
+    } else if (name == "fast") {
+        kind = BuildIdKind::FAST;
+    } else if (name == "sha1" || name == "tree") {
+        kind = BuildIdKind::SHA1;
+    } else if (name == "uuid") {
+        kind = BuildIdKind::UUID;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+size_t BuildIdHasher::hashSize(BuildIdKind kind) {
+    switch (kind) {
+        case BuildIdKind::FAST: return 8;
+        case BuildIdKind::SHA1: return 20;
+        case BuildIdKind::UUID: return 16;
+        default: return 0;
+    }
+}
+
+void BuildIdHasher::compute(BuildIdKind kind, const char* data, size_t size, std::vector<uint8_t>& id) {
+    id.assign(hashSize(kind), 0);
+
+    if (kind == BuildIdKind::UUID) {
+        std::random_device random;
+        for (auto& byte : id) {
+            byte = static_cast<uint8_t>(random());
+        }
+        id[6] = (id[6] & 0x0F) | 0x40;  // Version 4
+        id[8] = (id[8] & 0x3F) | 0x80;  // RFC 4122 variant
+        return;
+    }
+    if (kind != BuildIdKind::FAST && kind != BuildIdKind::SHA1) {
+        return;
+    }
+
+    // Leaf hashes, one per chunk
+    size_t digestSize = id.size();
+    size_t chunkCount = std::max<size_t>(1, (size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    std::vector<uint8_t> digests(chunkCount * digestSize);
+
+    parallelFor(chunkCount, [&](size_t i) {
+        const uint8_t* chunk = reinterpret_cast<const uint8_t*>(data) + i * CHUNK_SIZE;
+        size_t chunkSize = std::min(CHUNK_SIZE, size - std::min(size, i * CHUNK_SIZE));
+        uint8_t* digest = &digests[i * digestSize];
+
+        if (kind == BuildIdKind::FAST) {
+            uint64_t hash = xxHash64(chunk, chunkSize);
+            for (size_t b = 0; b < 8; ++b) {
+                digest[b] = static_cast<uint8_t>(hash >> (b * 8));
+            }
+        } else {
+            sha1(chunk, chunkSize, digest);
+        }
+    });
+
+    // Root hash over the concatenated leaf digests
+    if (kind == BuildIdKind::FAST) {
+        uint64_t hash = xxHash64(digests.data(), digests.size());
+        for (size_t b = 0; b < 8; ++b) {
+            id[b] = static_cast<uint8_t>(hash >> (b * 8));
+        }
+    } else {
+        sha1(digests.data(), digests.size(), id.data());
+    }
+}
+
+static inline uint64_t rotl64(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint32_t rotl32(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+static inline uint64_t read64le(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+static inline uint32_t read32le(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static const uint64_t XXH_PRIME64_1 = 11400714785074694791ULL;
+static const uint64_t XXH_PRIME64_2 = 14029467366897019727ULL;
+static const uint64_t XXH_PRIME64_3 = 1609587929392839161ULL;
+static const uint64_t XXH_PRIME64_4 = 9650029242287828579ULL;
+static const uint64_t XXH_PRIME64_5 = 2870177450012600261ULL;
+
+static inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+static inline uint64_t xxhMergeRound(uint64_t acc, uint64_t value) {
+    acc ^= xxhRound(0, value);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+// XXH64 with seed 0
+uint64_t BuildIdHasher::xxHash64(const uint8_t* data, size_t size) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t v1 = XXH_PRIME64_1 + XXH_PRIME64_2;
+        uint64_t v2 = XXH_PRIME64_2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - XXH_PRIME64_1;
+        do {
+            v1 = xxhRound(v1, read64le(p));
+            v2 = xxhRound(v2, read64le(p + 8));
+            v3 = xxhRound(v3, read64le(p + 16));
+            v4 = xxhRound(v4, read64le(p + 24));
+            p += 32;
+        } while (end - p >= 32);
+
+        hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        hash = xxhMergeRound(hash, v1);
+        hash = xxhMergeRound(hash, v2);
+        hash = xxhMergeRound(hash, v3);
+        hash = xxhMergeRound(hash, v4);
+    } else {
+        hash = XXH_PRIME64_5;
+    }
+    hash += static_cast<uint64_t>(size);
+
+    while (end - p >= 8) {
+        hash ^= xxhRound(0, read64le(p));
+        hash = rotl64(hash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        p += 8;
+    }
+    if (end - p >= 4) {
+        hash ^= static_cast<uint64_t>(read32le(p)) * XXH_PRIME64_1;
+        hash = rotl64(hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        hash ^= (*p++) * XXH_PRIME64_5;
+        hash = rotl64(hash, 11) * XXH_PRIME64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void BuildIdHasher::sha1(const uint8_t* data, size_t size, uint8_t digest[20]) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    // Padded message: data, 0x80, zeros, 64-bit big-endian bit length
+    size_t paddedSize = ((size + 8) / 64 + 1) * 64;
+    size_t fullBlocks = size / 64;
+    uint8_t tail[128];
+    std::memset(tail, 0, sizeof(tail));
+    size_t tailSize = paddedSize - fullBlocks * 64;
+    std::memcpy(tail, data + fullBlocks * 64, size - fullBlocks * 64);
+    tail[size - fullBlocks * 64] = 0x80;
+    uint64_t bitLength = static_cast<uint64_t>(size) * 8;
+    for (int i = 0; i < 8; ++i) {
+        tail[tailSize - 1 - i] = static_cast<uint8_t>(bitLength >> (i * 8));
+    }
+
+    size_t blockCount = paddedSize / 64;
+    for (size_t block = 0; block < blockCount; ++block) {
+        const uint8_t* chunk = block < fullBlocks ? data + block * 64 : tail + (block - fullBlocks) * 64;
+
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (static_cast<uint32_t>(chunk[i * 4]) << 24) | (static_cast<uint32_t>(chunk[i * 4 + 1]) << 16) |
+                   (static_cast<uint32_t>(chunk[i * 4 + 2]) << 8) | static_cast<uint32_t>(chunk[i * 4 + 3]);
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t temp = rotl32(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl32(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        digest[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+    }
+}
@@ -0,0 +1,326 @@
+#include "compression.h"
+#include "elf_structures.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <utility>
+
+#ifdef LINKER_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef LINKER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+const size_t SectionCompressor::CHUNK_SIZE;
+const uint64_t SectionCompressor::MAX_SECTION_SIZE;
+const uint64_t SectionCompressor::MAX_DEFLATE_RATIO;
+
+bool parseDebugCompression(const std::string& name, DebugCompression& compression) {
+    if (name == "none") {
+        compression = DebugCompression::NONE;
+    } else if (name == "zlib") {
+        compression = DebugCompression::ZLIB;
+    } else if (name == "zstd") {
+        compression = DebugCompression::ZSTD;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool isDebugCompressionAvailable(DebugCompression compression) {
+    switch (compression) {
+        case DebugCompression::NONE:
+            return true;
+        case DebugCompression::ZLIB:
+#ifdef LINKER_HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case DebugCompression::ZSTD:
+#ifdef LINKER_HAVE_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+static bool isDebugOutput(const OutputSection& section) {
+    return !(section.flags & SHF_ALLOC) && section.name.compare(0, 6, ".debug") == 0;
+}
+
+// Older GNU toolchains (-gz=zlib-gnu) compress .debug_* into .zdebug_* with
+// a "ZLIB" magic and a big-endian size instead of SHF_COMPRESSED
+static bool isGnuCompressed(const InputSection& section) {
+    return !(section.flags & SHF_COMPRESSED) && section.name.compare(0, 7, ".zdebug") == 0;
+}
+
+bool SectionCompressor::decompressInputs(std::vector<ObjectFile>& objects) {
+    std::vector<std::pair<size_t, size_t> > compressed;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        for (size_t j = 0; j < objects[i].sections.size(); ++j) {
+            const InputSection& section = objects[i].sections[j];
+            if (objects[i].platform == Platform::ELF && ((section.flags & SHF_COMPRESSED) || isGnuCompressed(section))) {
+                compressed.push_back(std::make_pair(i, j));
+            }
+        }
+    }
+    if (compressed.empty()) {
+        return true;
+    }
+
+    // A section that cannot be decompressed fails the link rather than
+    // silently shipping without its debug info
+    std::vector<char> failed(compressed.size(), 0);
+    parallelFor(compressed.size(), [&](size_t k) {
+        ObjectFile& object = objects[compressed[k].first];
+        InputSection& section = object.sections[compressed[k].second];
+        try {
+            failed[k] = !decompressSection(section, object.path);
+        } catch (const std::exception& e) {
+            std::cerr << "Error decompressing section " << section.name << " in: " << object.path
+                      << " (" << e.what() << ")" << std::endl;
+            failed[k] = 1;
+        }
+    });
+
+    for (char sectionFailed : failed) {
+        if (sectionFailed) {
+            return false;
+        }
+    }
+    std::cout << "Decompressed " << compressed.size() << " input sections" << std::endl;
+    return true;
+}
+
+bool SectionCompressor::decompressSection(InputSection& section, const std::string& filePath) {
+    Elf64_Chdr header;
+    const std::vector<char>& raw = section.bytes();
+    std::string name = section.name;
+    size_t headerSize;
+
+    if (isGnuCompressed(section)) {
+        headerSize = 12;
+        if (raw.size() < headerSize || std::memcmp(raw.data(), "ZLIB", 4) != 0) {
+            std::cerr << "Invalid .zdebug header in " << section.name << " of: " << filePath << std::endl;
+            return false;
+        }
+        header.ch_type = ELFCOMPRESS_ZLIB;
+        header.ch_size = 0;
+        for (size_t i = 4; i < headerSize; ++i) {
+            header.ch_size = (header.ch_size << 8) | static_cast<uint8_t>(raw[i]);
+        }
+        header.ch_addralign = section.addralign;
+        name = ".debug" + section.name.substr(7);
+    } else {
+        headerSize = sizeof(header);
+        if (raw.size() < headerSize) {
+            std::cerr << "Truncated compression header in " << section.name << " of: " << filePath << std::endl;
+            return false;
+        }
+        std::memcpy(&header, raw.data(), sizeof(header));
+    }
+
+    const char* payload = raw.data() + headerSize;
+    size_t payloadSize = raw.size() - headerSize;
+
+    // ch_size comes from the file; reject sizes no valid stream of this length could produce
+    if (header.ch_size > MAX_SECTION_SIZE ||
+        (header.ch_type == ELFCOMPRESS_ZLIB && header.ch_size > payloadSize * MAX_DEFLATE_RATIO)) {
+        std::cerr << "Implausible uncompressed size " << header.ch_size << " for section " << section.name
+                  << " in: " << filePath << std::endl;
+        return false;
+    }
+    std::vector<char> contents(header.ch_size);
+    bool ok = false;
+
+    switch (header.ch_type) {
+        case ELFCOMPRESS_ZLIB: {
+#ifdef LINKER_HAVE_ZLIB
+            uLongf destSize = static_cast<uLongf>(contents.size());
+            ok = uncompress(reinterpret_cast<Bytef*>(contents.data()), &destSize,
+                            reinterpret_cast<const Bytef*>(payload), static_cast<uLong>(payloadSize)) == Z_OK &&
+                 destSize == contents.size();
+#endif
+            break;
+        }
+        case ELFCOMPRESS_ZSTD: {
+#ifdef LINKER_HAVE_ZSTD
+            size_t result = ZSTD_decompress(contents.data(), contents.size(), payload, payloadSize);
+            ok = !ZSTD_isError(result) && result == contents.size();
+#endif
+            break;
+        }
+        default:
+            break;
+    }
+
+    if (!ok) {
+        std::cerr << "Error decompressing section " << section.name << " (type " << header.ch_type
+                  << ") in: " << filePath << std::endl;
+        return false;
+    }
+
+    // Replaces this copy's contents only; the object cache stores the section after this runs
+    section.data = std::make_shared<const std::vector<char> >(std::move(contents));
+    section.name = name;
+    section.size = header.ch_size;
+    section.addralign = header.ch_addralign ? header.ch_addralign : 1;
+    section.flags &= ~static_cast<uint64_t>(SHF_COMPRESSED);
+    return true;
+}
+
+void SectionCompressor::compressOutputs(const std::vector<ObjectFile>& objects, Layout& layout, DebugCompression compression) {
+    if (compression == DebugCompression::NONE) {
+        return;
+    }
+
+    const std::vector<OutputSection>& sections = layout.getOutputSections();
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const OutputSection& section = sections[i];
+        if (!isDebugOutput(section) || section.size == 0) {
+            continue;
+        }
+
+        // Assemble the uncompressed contents
+        std::vector<char> contents(section.size, 0);
+        for (const auto& placement : section.inputs) {
+            const InputSection& input = objects[placement.objectIndex].sections[placement.sectionIndex];
+            const std::vector<char>& bytes = input.bytes();
+            if (!bytes.empty()) {
+                std::memcpy(&contents[placement.offset], bytes.data(), bytes.size());
+            }
+        }
+
+        Elf64_Chdr header;
+        header.ch_type = (compression == DebugCompression::ZLIB) ? ELFCOMPRESS_ZLIB : ELFCOMPRESS_ZSTD;
+        header.ch_reserved = 0;
+        header.ch_size = section.size;
+        header.ch_addralign = section.addralign;
+
+        std::vector<char> compressed(reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header) + sizeof(header));
+        bool ok = (compression == DebugCompression::ZLIB) ? compressZlib(contents, compressed)
+                                                           : compressZstd(contents, compressed);
+        if (!ok) {
+            std::cerr << "Error compressing output section: " << section.name << std::endl;
+            continue;
+        }
+
+        // Keep the section uncompressed if compression does not pay off
+        if (compressed.size() < section.size) {
+            layout.setCompressedContents(i, compressed);
+        }
+    }
+}
+
+// Each chunk is deflated as an independent raw stream ending on a byte
+// boundary, so the pieces concatenate into one zlib stream. The Adler-32
+// checksums of the chunks are combined for the trailer.
+bool SectionCompressor::compressZlib(const std::vector<char>& contents, std::vector<char>& compressed) {
+#ifdef LINKER_HAVE_ZLIB
+    size_t chunkCount = (contents.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<std::vector<char> > chunks(chunkCount);
+    std::vector<uLong> checksums(chunkCount);
+    std::vector<char> failed(chunkCount, 0);
+
+    parallelFor(chunkCount, [&](size_t i) {
+        const Bytef* input = reinterpret_cast<const Bytef*>(contents.data()) + i * CHUNK_SIZE;
+        size_t inputSize = std::min(CHUNK_SIZE, contents.size() - i * CHUNK_SIZE);
+        bool last = (i + 1 == chunkCount);
+
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            failed[i] = 1;
+            return;
+        }
+
+        // deflateBound covers Z_FINISH; a sync flush adds an empty stored block
+        std::vector<char>& output = chunks[i];
+        output.resize(deflateBound(&stream, static_cast<uLong>(inputSize)) + 16);
+        stream.next_in = const_cast<Bytef*>(input);
+        stream.avail_in = static_cast<uInt>(inputSize);
+        stream.next_out = reinterpret_cast<Bytef*>(output.data());
+        stream.avail_out = static_cast<uInt>(output.size());
+
+        int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        if ((last && result != Z_STREAM_END) || (!last && (result != Z_OK || stream.avail_in != 0))) {
+            failed[i] = 1;
+        }
+        output.resize(stream.total_out);
+        deflateEnd(&stream);
+
+        checksums[i] = adler32(adler32(0L, Z_NULL, 0), input, static_cast<uInt>(inputSize));
+    });
+
+    for (char chunkFailed : failed) {
+        if (chunkFailed) {
+            return false;
+        }
+    }
+
+    // zlib header: deflate, 32K window, default level
+    compressed.push_back(static_cast<char>(0x78));
+    compressed.push_back(static_cast<char>(0x9C));
+
+    uLong checksum = adler32(0L, Z_NULL, 0);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        compressed.insert(compressed.end(), chunks[i].begin(), chunks[i].end());
+        size_t inputSize = std::min(CHUNK_SIZE, contents.size() - i * CHUNK_SIZE);
+        checksum = adler32_combine(checksum, checksums[i], static_cast<z_off_t>(inputSize));
+    }
+
+    // Adler-32 trailer is big-endian
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        compressed.push_back(static_cast<char>((checksum >> shift) & 0xFF));
+    }
+    return true;
+#else
+    (void)contents;
+    (void)compressed;
+    std::cerr << "zlib support is not available in this build" << std::endl;
+    return false;
+#endif
+}
+
+// zstd frames can be concatenated, so each chunk is compressed as its own frame.
+bool SectionCompressor::compressZstd(const std::vector<char>& contents, std::vector<char>& compressed) {
+#ifdef LINKER_HAVE_ZSTD
+    size_t chunkCount = (contents.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<std::vector<char> > chunks(chunkCount);
+    std::vector<char> failed(chunkCount, 0);
+
+    parallelFor(chunkCount, [&](size_t i) {
+        const char* input = contents.data() + i * CHUNK_SIZE;
+        size_t inputSize = std::min(CHUNK_SIZE, contents.size() - i * CHUNK_SIZE);
+
+        std::vector<char>& output = chunks[i];
+        output.resize(ZSTD_compressBound(inputSize));
+        size_t result = ZSTD_compress(output.data(), output.size(), input, inputSize, ZSTD_CLEVEL_DEFAULT);
+        if (ZSTD_isError(result)) {
+            failed[i] = 1;
+            return;
+        }
+        output.resize(result);
+    });
+
+    for (size_t i = 0; i < chunkCount; ++i) {
+        if (failed[i]) {
+            return false;
+        }
+        compressed.insert(compressed.end(), chunks[i].begin(), chunks[i].end());
+    }
+    return true;
+#else
+    (void)contents;
+    (void)compressed;
+    std::cerr << "zstd support is not available in this build" << std::endl;
+    return false;
+#endif
+}
@@ -0,0 +1,278 @@
+#include "layout.h"
+#include "elf_structures.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+static uint64_t alignTo(uint64_t value, uint64_t align) {
+    return align > 1 ? (value + align - 1) / align * align : value;
+}
+
+static bool isDebugSection(const std::string& name) {
+    return name.compare(0, 6, ".debug") == 0;  // .zdebug inputs are renamed when decompressed
+}
+
+// Sections that carry link metadata rather than image contents
+static bool isOutputCandidate(const InputSection& section) {
+    if (section.size == 0) {
+        return false;
+    }
+    switch (section.type) {
+        case SHT_NULL:
+        case SHT_SYMTAB:
+        case SHT_STRTAB:
+        case SHT_RELA:
+        case SHT_REL:
+        case 17:  // SHT_GROUP
+            return false;
+        default:
+            return (section.flags & SHF_ALLOC) || isDebugSection(section.name);
+    }
+}
+
+// Output sections are ordered text, read-only data, writable data, bss, then non-allocated
+static int sectionRank(const OutputSection& section) {
+    if (!(section.flags & SHF_ALLOC)) return 4;
+    if (section.type == SHT_NOBITS) return 3;
+    if (section.flags & SHF_EXECINSTR) return 0;
+    if (section.flags & SHF_WRITE) return 2;
+    return 1;
+}
+
+// Sort key within an output section: sections named by the ordering file
+// first, then .text.hot.*, then everything else, then .text.unlikely.*
+static int sectionTemperature(const std::string& name) {
+    if (name.compare(0, 10, ".text.hot.") == 0 || name == ".text.hot") return 0;
+    if (name.compare(0, 15, ".text.unlikely.") == 0 || name == ".text.unlikely") return 2;
+    return 1;
+}
+
+std::string Layout::outputSectionName(const std::string& inputName) {
+    // COFF grouped sections (.text$mn) merge into their base section
+    size_t dollar = inputName.find('$');
+    if (dollar != std::string::npos) {
+        return inputName.substr(0, dollar);
+    }
+
+    static const char* prefixes[] = {".text", ".rodata", ".data", ".bss"};
+    for (const char* prefix : prefixes) {
+        std::string base(prefix);
+        if (inputName.compare(0, base.size() + 1, base + ".") == 0) {
+            return base;
+        }
+    }
+    return inputName;
+}
+
+bool Layout::readSymbolOrderingFile(const std::string& filePath, std::vector<std::string>& symbolOrder) {
+    std::ifstream file(filePath);
+
+    if (!file.is_open()) {
+        std::cerr << "Error opening symbol ordering file: " << filePath << std::endl;
+        return false;
+    }
+
+    // One symbol per line; blank lines and '#' comments are ignored
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            continue;
+        }
+        size_t end = line.find_last_not_of(" \t\r");
+        symbolOrder.push_back(line.substr(begin, end - begin + 1));
+    }
+    return true;
+}
+
+void Layout::setSymbolOrder(const std::vector<std::string>& symbolOrder, const SymbolTable& symbolTable,
+                            const std::vector<ObjectFile>& objects) {
+    sectionPriority.clear();
+
+    for (size_t i = 0; i < symbolOrder.size(); ++i) {
+        std::vector<const SymbolInfo*> definitions = symbolTable.findDefinitions(symbolOrder[i]);
+        if (definitions.empty()) {
+            std::cerr << "warning: symbol ordering file: no such symbol: " << symbolOrder[i] << std::endl;
+            continue;
+        }
+
+        // Only code is reordered; every definition of the name (e.g. static
+        // functions in several objects) is placed. A section keeps the
+        // position of the first symbol listed for it.
+        bool placed = false;
+        for (const SymbolInfo* symbol : definitions) {
+            if (symbol->objectIndex >= objects.size() || symbol->sectionIndex < 0 ||
+                static_cast<size_t>(symbol->sectionIndex) >= objects[symbol->objectIndex].sections.size()) {
+                continue;
+            }
+            const InputSection& section = objects[symbol->objectIndex].sections[symbol->sectionIndex];
+            if (!(section.flags & SHF_EXECINSTR)) {
+                continue;
+            }
+            placed = true;
+            std::pair<size_t, size_t> key(symbol->objectIndex, static_cast<size_t>(symbol->sectionIndex));
+            if (sectionPriority.find(key) == sectionPriority.end()) {
+                sectionPriority[key] = i;
+            }
+        }
+        if (!placed) {
+            std::cerr << "warning: symbol ordering file: not in an executable section: " << symbolOrder[i] << std::endl;
+        }
+    }
+}
+
+void Layout::assign(const std::vector<ObjectFile>& objects) {
+    outputSections.clear();
+    inputAddresses.assign(objects.size(), std::vector<int64_t>());
+
+    // Group input sections by output section name, in first-seen order
+    std::map<std::string, size_t> indexByName;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        inputAddresses[i].assign(objects[i].sections.size(), -1);
+
+        for (size_t j = 0; j < objects[i].sections.size(); ++j) {
+            const InputSection& input = objects[i].sections[j];
+            if (!isOutputCandidate(input)) {
+                continue;
+            }
+
+            std::string name = outputSectionName(input.name);
+            auto it = indexByName.find(name);
+            if (it == indexByName.end()) {
+                OutputSection section;
+                section.name = name;
+                section.type = input.type;
+                section.flags = input.flags;
+                section.addr = 0;
+                section.fileOffset = 0;
+                section.size = 0;
+                section.addralign = 1;
+                it = indexByName.insert(std::make_pair(name, outputSections.size())).first;
+                outputSections.push_back(section);
+            }
+
+            OutputSection& section = outputSections[it->second];
+            section.flags |= input.flags;
+            if (input.type != SHT_NOBITS) {
+                section.type = input.type;
+            }
+            SectionPlacement placement = {i, j, 0};
+            section.inputs.push_back(placement);
+        }
+    }
+
+    // Apply the profile-guided order within each output section
+    for (auto& section : outputSections) {
+        std::stable_sort(section.inputs.begin(), section.inputs.end(),
+                         [&](const SectionPlacement& a, const SectionPlacement& b) {
+                             auto pa = sectionPriority.find(std::make_pair(a.objectIndex, a.sectionIndex));
+                             auto pb = sectionPriority.find(std::make_pair(b.objectIndex, b.sectionIndex));
+                             bool orderedA = pa != sectionPriority.end();
+                             bool orderedB = pb != sectionPriority.end();
+                             if (orderedA || orderedB) {
+                                 return orderedA && (!orderedB || pa->second < pb->second);
+                             }
+                             return sectionTemperature(objects[a.objectIndex].sections[a.sectionIndex].name) <
+                                    sectionTemperature(objects[b.objectIndex].sections[b.sectionIndex].name);
+                         });
+    }
+
+    std::stable_sort(outputSections.begin(), outputSections.end(),
+                     [](const OutputSection& a, const OutputSection& b) { return sectionRank(a) < sectionRank(b); });
+
+    for (auto& section : outputSections) {
+        uint64_t offset = 0;
+
+        for (auto& placement : section.inputs) {
+            const InputSection& input = objects[placement.objectIndex].sections[placement.sectionIndex];
+            offset = alignTo(offset, input.addralign);
+            placement.offset = offset;
+            offset += input.size;
+            section.addralign = std::max(section.addralign, input.addralign);
+        }
+        section.size = offset;
+    }
+    assignFileOffsets();
+
+    std::cout << "Layout assigned " << outputSections.size() << " output sections" << std::endl;
+}
+
+void Layout::assignFileOffsets() {
+    // Allocated sections start on the page after the ELF and program headers;
+    // every allocated section gets a PT_LOAD and notes also get a PT_NOTE
+    size_t programHeaderCount = 0;
+    for (const auto& section : outputSections) {
+        if (section.flags & SHF_ALLOC) {
+            programHeaderCount += (section.type == SHT_NOTE) ? 2 : 1;
+        }
+    }
+    uint64_t fileOffset = alignTo(sizeof(ELFHeader) + programHeaderCount * sizeof(ELFProgramHeader), SEGMENT_ALIGN);
+
+    // NOBITS sections take address space but no file space, so the virtual
+    // address cursor runs ahead of the file offset once one has been placed
+    uint64_t address = IMAGE_BASE + fileOffset;
+
+    for (auto& section : outputSections) {
+        bool isAlloc = (section.flags & SHF_ALLOC) != 0;
+        bool isCompressed = (section.flags & SHF_COMPRESSED) != 0;
+
+        // Each allocated section gets its own page so it can carry its own permissions
+        if (isAlloc) {
+            fileOffset = alignTo(fileOffset, SEGMENT_ALIGN);
+            address = alignTo(address, SEGMENT_ALIGN);
+            section.addr = address;
+            address += section.size;
+        } else {
+            fileOffset = alignTo(fileOffset, isCompressed ? sizeof(uint64_t) : section.addralign);
+        }
+        section.fileOffset = fileOffset;
+        if (isCompressed) {
+            fileOffset += section.compressedData.size();
+        } else if (section.type != SHT_NOBITS) {
+            fileOffset += section.size;
+        }
+
+        for (const auto& placement : section.inputs) {
+            inputAddresses[placement.objectIndex][placement.sectionIndex] =
+                static_cast<int64_t>((isAlloc ? section.addr : 0) + placement.offset);
+        }
+    }
+    imageSize = fileOffset;
+}
+
+void Layout::setCompressedContents(size_t sectionIndex, std::vector<char>& contents) {
+    OutputSection& section = outputSections[sectionIndex];
+    section.compressedData.swap(contents);
+    section.flags |= SHF_COMPRESSED;
+    assignFileOffsets();
+}
+
+const std::vector<OutputSection>& Layout::getOutputSections() const {
+    return outputSections;
+}
+
+uint64_t Layout::getImageSize() const {
+    return imageSize;
+}
+
+bool Layout::getInputSectionAddress(size_t objectIndex, size_t sectionIndex, uint64_t& address) const {
+    if (objectIndex >= inputAddresses.size() || sectionIndex >= inputAddresses[objectIndex].size() ||
+        inputAddresses[objectIndex][sectionIndex] < 0) {
+        return false;
+    }
+    address = static_cast<uint64_t>(inputAddresses[objectIndex][sectionIndex]);
+    return true;
+}
+
+uint64_t Layout::getSymbolAddress(const SymbolInfo& symbol) const {
+    uint64_t base = 0;
+    if (symbol.sectionIndex < 0 ||
+        !getInputSectionAddress(symbol.objectIndex, static_cast<size_t>(symbol.sectionIndex), base)) {
+        return symbol.value;
+    }
+    return base + symbol.value;
+}
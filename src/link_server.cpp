@@ -0,0 +1,287 @@
+#include "link_server.h"
+#include "linker.h"
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+
+const int LinkServer::REQUEST_TIMEOUT_SECONDS;
+const size_t LinkServer::MAX_REQUEST_SIZE;
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <climits>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static bool makeAddress(const std::string& socketPath, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << socketPath << std::endl;
+        return false;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    return true;
+}
+
+static bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Reads NUL-terminated fields until an empty field. Fails on end of stream,
+// on the receive timeout set on the socket, or once the request grows past
+// maxSize, so a stalled client cannot hold up the server.
+static bool readFields(int fd, size_t maxSize, std::vector<std::string>& fields) {
+    std::string current;
+    char buffer[4096];
+    ssize_t count;
+    size_t total = 0;
+
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+        total += static_cast<size_t>(count);
+        if (total > maxSize) {
+            std::cerr << "Link request exceeds " << maxSize << " bytes" << std::endl;
+            return false;
+        }
+        for (ssize_t i = 0; i < count; ++i) {
+            if (buffer[i] != '\0') {
+                current += buffer[i];
+            } else if (current.empty()) {
+                return true;
+            } else {
+                fields.push_back(current);
+                current.clear();
+            }
+        }
+    }
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        std::cerr << "Timed out reading link request" << std::endl;
+    } else {
+        std::cerr << "Incomplete link request" << std::endl;
+    }
+    return false;
+}
+
+// Unbuffered streambuf that appends to a string under a lock, so the map
+// thread, the output writer and worker threads can all report at once
+class LockedStringBuf : public std::streambuf {
+public:
+    std::string str() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return text;
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            std::lock_guard<std::mutex> lock(mutex);
+            text += traits_type::to_char_type(ch);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        text.append(data, static_cast<size_t>(count));
+        return count;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::string text;
+};
+
+// Sends std::cerr into a buffer for the lifetime of the object
+class DiagnosticCapture {
+public:
+    DiagnosticCapture() : previous(std::cerr.rdbuf(&buffer)) {}
+    ~DiagnosticCapture() { std::cerr.rdbuf(previous); }
+    std::string text() const { return buffer.str(); }
+
+private:
+    LockedStringBuf buffer;
+    std::streambuf* previous;
+};
+
+bool LinkServer::serve(const std::string& socketPath) {
+    sockaddr_un address;
+    if (!makeAddress(socketPath, address)) {
+        return false;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        std::cerr << "Error creating socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Only replace a stale socket; never delete some other file at the path
+    struct stat st;
+    if (lstat(socketPath.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            std::cerr << "Refusing to replace non-socket file: " << socketPath << std::endl;
+            close(listener);
+            return false;
+        }
+        unlink(socketPath.c_str());
+    }
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 16) != 0) {
+        std::cerr << "Error listening on socket " << socketPath << ": " << std::strerror(errno) << std::endl;
+        close(listener);
+        return false;
+    }
+
+    // A client that disconnects early must not take the server down
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cout << "Link server listening on: " << socketPath << std::endl;
+
+    // Requests are handled one at a time; each one changes into the client's directory
+    while (true) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error accepting connection: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        timeval timeout;
+        timeout.tv_sec = REQUEST_TIMEOUT_SECONDS;
+        timeout.tv_usec = 0;
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        // The request's diagnostics go back to the client, and are also kept
+        // in the server's own log
+        std::vector<std::string> fields;
+        bool ok;
+        std::string diagnostics;
+        {
+            DiagnosticCapture capture;
+            ok = readFields(client, MAX_REQUEST_SIZE, fields) && handleRequest(fields);
+            diagnostics = capture.text();
+        }
+        std::cerr << diagnostics;
+
+        std::string reply = (ok ? "ok\n" : "error\n") + diagnostics;
+        writeAll(client, reply.data(), reply.size());
+        close(client);
+
+        // Forget objects that were deleted or rebuilt since they were cached
+        objectCache.prune();
+    }
+
+    close(listener);
+    unlink(socketPath.c_str());
+    return false;
+}
+
+bool LinkServer::handleRequest(const std::vector<std::string>& fields) {
+    if (fields.empty()) {
+        std::cerr << "Empty link request" << std::endl;
+        return false;
+    }
+    if (chdir(fields[0].c_str()) != 0) {
+        std::cerr << "Error changing to client directory " << fields[0] << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> args(fields.begin() + 1, fields.end());
+    LinkerOptions options;
+    std::vector<std::string> inputFiles;
+    if (!parseLinkerArguments(args, options, inputFiles)) {
+        return false;
+    }
+    if (!options.serveSocket.empty() || !options.connectSocket.empty()) {
+        std::cerr << "Nested server options are not allowed in a link request" << std::endl;
+        return false;
+    }
+
+    std::cout << "Handling link request for " << inputFiles.size() << " input files in: " << fields[0] << std::endl;
+    Linker linker;
+    linker.setObjectCache(&objectCache);
+    return linker.link(selectObjectFiles(inputFiles), options);
+}
+
+int LinkServer::sendRequest(const std::string& socketPath, const std::vector<std::string>& args) {
+    sockaddr_un address;
+    if (!makeAddress(socketPath, address)) {
+        return 1;
+    }
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0 || connect(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Error connecting to link server " << socketPath << ": " << std::strerror(errno) << std::endl;
+        if (server >= 0) {
+            close(server);
+        }
+        return 1;
+    }
+
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, sizeof(cwd))) {
+        std::cerr << "Error reading working directory: " << std::strerror(errno) << std::endl;
+        close(server);
+        return 1;
+    }
+
+    std::string request(cwd);
+    request += '\0';
+    for (const auto& arg : args) {
+        request += arg;
+        request += '\0';
+    }
+    request += '\0';
+
+    std::string reply;
+    if (writeAll(server, request.data(), request.size())) {
+        char buffer[64];
+        ssize_t count;
+        while ((count = read(server, buffer, sizeof(buffer))) > 0) {
+            reply.append(buffer, static_cast<size_t>(count));
+        }
+    }
+    close(server);
+
+    // First line is the status, the rest is the server-side diagnostics
+    size_t newline = reply.find('\n');
+    std::string status = reply.substr(0, newline);
+    if (newline != std::string::npos) {
+        std::cerr << reply.substr(newline + 1);
+    }
+
+    if (status != "ok") {
+        std::cerr << "Link server reported failure" << std::endl;
+        return 1;
+    }
+    std::cout << "Linking completed by server." << std::endl;
+    return 0;
+}
+
+#else
+
+bool LinkServer::serve(const std::string& socketPath) {
+    std::cerr << "Server mode is not supported on this platform: " << socketPath << std::endl;
+    return false;
+}
+
+int LinkServer::sendRequest(const std::string& socketPath, const std::vector<std::string>& args) {
+    std::cerr << "Server mode is not supported on this platform: " << socketPath << std::endl;
+    return 1;
+}
+
+#endif
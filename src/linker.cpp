@@ -6,8 +6,15 @@
 #include "platform_utils.h"
 #include "coff_structures.h"
 #include "elf_structures.h" // Add ELF structures
+#include "object_file.h"
+#include "layout.h"
+#include "map_file.h"
+#include "output_writer.h"
+#include "object_cache.h"
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <thread>
 
 void parseELF(const std::string& filePath, SymbolTable& symbolTable) {
     std::ifstream file(filePath, std::ios::binary);
@@ -100,39 +107,229 @@ void parseCOFF(const std::string& filePath, SymbolTable& symbolTable) {
 }
 
 
-void Linker::link(const std::vector<std::string>& objectFiles) {
-    Relocation relocation;
+bool parseLinkerArguments(const std::vector<std::string>& args, LinkerOptions& options, std::vector<std::string>& inputFiles) {
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+
+        if (arg == "-o" && hasValue) {
+            options.outputFile = args[++i];
+        } else if (arg.compare(0, 5, "-Map=") == 0) {
+            options.mapFile = arg.substr(5);
+        } else if (arg.compare(0, 11, "--json-map=") == 0) {
+            options.jsonMapFile = arg.substr(11);
+        } else if (arg.compare(0, 23, "--symbol-ordering-file=") == 0) {
+            options.symbolOrderingFile = arg.substr(23);
+        } else if (arg == "--symbol-ordering-file" && hasValue) {
+            options.symbolOrderingFile = args[++i];
+        } else if (arg.compare(0, 26, "--compress-debug-sections=") == 0) {
+            if (!parseDebugCompression(arg.substr(26), options.compressDebugSections)) {
+                std::cerr << "Unknown debug section compression: " << arg.substr(26) << std::endl;
+                return false;
+            }
+            if (!isDebugCompressionAvailable(options.compressDebugSections)) {
+                std::cerr << "Debug section compression not available in this build: " << arg.substr(26) << std::endl;
+                return false;
+            }
+        } else if (arg == "--build-id") {
+            options.buildId = BuildIdKind::FAST;
+        } else if (arg.compare(0, 11, "--build-id=") == 0) {
+            if (!parseBuildIdKind(arg.substr(11), options.buildId)) {
+                std::cerr << "Unknown build ID style: " << arg.substr(11) << std::endl;
+                return false;
+            }
+        } else if (arg == "--serve" && hasValue) {
+            options.serveSocket = args[++i];
+        } else if (arg == "--connect" && hasValue) {
+            options.connectSocket = args[++i];
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        } else {
+            inputFiles.push_back(arg);
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> selectObjectFiles(const std::vector<std::string>& inputFiles) {
+    PlatformDetector detector;
+    std::vector<std::string> objectFiles;
+
+    for (const auto& objectFile : inputFiles) {
+        Platform platform = detector.detectPlatform(objectFile);
+
+        switch (platform) {
+            case Platform::ELF:
+                std::cout << "ELF format detected in " << objectFile << std::endl;
+                break;
+            case Platform::PE:
+                std::cout << "PE format detected in " << objectFile << std::endl;
+                break;
+            case Platform::MACHO:
+                std::cout << "Mach-O format detected in " << objectFile << std::endl;
+                break;
+            case Platform::COFF:
+                std::cout << "Coff format detected in " << objectFile << std::endl;
+                break;
+            default:
+                std::cout << "Unknown format in " << objectFile << std::endl;
+                continue; // Skip to the next file if format is unknown
+        }
+
+        objectFiles.push_back(objectFile);
+    }
+    return objectFiles;
+}
+
+// Joins a thread when it goes out of scope so an exception cannot leave it joinable
+class ThreadJoiner {
+public:
+    explicit ThreadJoiner(std::thread& thread) : thread(thread) {}
+    ~ThreadJoiner() { join(); }
+    void join() {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+private:
+    std::thread& thread;
+};
+
+void Linker::setObjectCache(ObjectCache* cache) {
+    objectCache = cache;
+}
+
+bool Linker::link(const std::vector<std::string>& objectFiles, const LinkerOptions& options) {
     Parser parser;
     SymbolTable symbolTable;
     PlatformDetector detector;
+    std::vector<ObjectFile> objects;
+
+    // Freshly parsed objects are cached once their debug sections are
+    // decompressed, so later links reuse the inflated contents
+    struct PendingStore {
+        size_t objectIndex;
+        FileStamp stamp;
+        std::vector<SymbolInfo> symbols;
+    };
+    std::vector<PendingStore> pendingStores;
 
     for (const auto& objectFile : objectFiles) {
-        // Detect the platform
-        Platform platform = detector.detectPlatform(objectFile);
-        std::cout << "Linking object file: " << objectFile << " (" << platformToString(platform) << ")" << std::endl;
+        ObjectFile object;
+        std::vector<SymbolInfo> symbols;
 
-        // Call the parse function with platform-specific logic
-        parser.parse(objectFile, symbolTable, platform);
+        const CachedObject* cached = objectCache ? objectCache->lookup(objectFile) : nullptr;
+        if (cached) {
+            std::cout << "Reusing cached object file: " << objectFile << std::endl;
+            object = cached->object;  // Shares section contents with the cache
+            object.path = objectFile;  // Entries are keyed by canonical path; report the name this link used
+            symbols = cached->symbols;
+        } else {
+            // Sections and symbols are read straight from the input; nothing
+            // in this pipeline writes back into the object file
+            FileStamp stamp;
+            bool hasStamp = objectCache && ObjectCache::readStamp(objectFile, stamp);  // Before any read
+            Platform platform = detector.detectPlatform(objectFile);
+            std::cout << "Linking object file: " << objectFile << " (" << platformToString(platform) << ")" << std::endl;
 
-        // Apply relocations based on the platform
-        switch (platform) {
-            case Platform::COFF:  // COFF files
-                COFFHeader coffHeader;
-                parser.parseCOFFHeader(objectFile, coffHeader);
-                relocation.applyCOFFRelocations(coffHeader, objectFile);
-                break;
+            SymbolTable objectSymbols;
+            if (!parser.parseObject(objectFile, platform, 0, object, objectSymbols)) {
+                std::cerr << "Error reading object file: " << objectFile << std::endl;
+                return false;
+            }
+            symbols = objectSymbols.getSymbols();
+            if (hasStamp) {
+                PendingStore pending = {objects.size(), stamp, symbols};
+                pendingStores.push_back(pending);
+            }
+        }
 
-            case Platform::ELF:  // ELF files
-                ELFHeader elfHeader;  // Use ELFHeader instead of ELFHeader
-                parser.parseELFHeader(objectFile, elfHeader);
-                relocation.applyELFRelocations(elfHeader, objectFile);
-                break;
+        for (auto& symbol : symbols) {
+            symbol.objectIndex = objects.size();
+            symbolTable.addSymbol(symbol);
+        }
+        objects.push_back(std::move(object));
+    }
 
-            default:
-                std::cerr << "Unknown platform. Skipping relocation." << std::endl;
-                break;
+    // Inputs built with -gz carry compressed debug sections
+    SectionCompressor compressor;
+    if (!compressor.decompressInputs(objects)) {
+        return false;
+    }
+    for (const auto& pending : pendingStores) {
+        objectCache->store(objectFiles[pending.objectIndex], pending.stamp, objects[pending.objectIndex], pending.symbols);
+    }
+
+    // Input build ID notes describe their own objects, not this output, and
+    // would otherwise merge with the linker's note; drop them as lld does
+    for (auto& object : objects) {
+        for (auto& section : object.sections) {
+            if (section.name == OutputWriter::BUILD_ID_SECTION) {
+                section.size = 0;
+                section.data.reset();
+            }
+        }
+    }
+
+    // The build ID note is laid out like an input section from a synthetic object
+    if (options.buildId != BuildIdKind::NONE && !objects.empty()) {
+        size_t descSize = BuildIdHasher::hashSize(options.buildId);
+        InputSection note;
+        note.name = OutputWriter::BUILD_ID_SECTION;
+        note.type = SHT_NOTE;
+        note.flags = SHF_ALLOC;
+        note.size = 16 + descSize;
+        note.addralign = 4;
+        std::vector<char> contents(note.size, 0);
+        uint32_t header[3] = {4, static_cast<uint32_t>(descSize), NT_GNU_BUILD_ID};  // namesz, descsz, type
+        std::memcpy(contents.data(), header, sizeof(header));
+        std::memcpy(contents.data() + sizeof(header), "GNU", 4);
+        note.data = std::make_shared<const std::vector<char> >(std::move(contents));
+
+        ObjectFile synthetic;
+        synthetic.path = "<internal>";
+        synthetic.platform = Platform::ELF;
+        synthetic.machine = objects[0].machine;
+        synthetic.sections.push_back(note);
+        objects.push_back(synthetic);
+    }
+
+    Layout layout;
+    if (!options.symbolOrderingFile.empty()) {
+        std::vector<std::string> symbolOrder;
+        if (!Layout::readSymbolOrderingFile(options.symbolOrderingFile, symbolOrder)) {
+            return false;
         }
+        layout.setSymbolOrder(symbolOrder, symbolTable, objects);
     }
+    layout.assign(objects);
+    compressor.compressOutputs(objects, layout, options.compressDebugSections);
+
+    // The map only reads the layout and symbol table, so it is written on a
+    // background thread while the output image is being written. The guard
+    // joins it on every path out of this scope, including exceptions.
+    std::thread mapThread;
+    ThreadJoiner mapJoiner(mapThread);
+    bool mapWritten = true;
+    if (!options.mapFile.empty() || !options.jsonMapFile.empty()) {
+        mapThread = std::thread([&]() {
+            MapFile mapFile;
+            if (!options.mapFile.empty() && !mapFile.writeText(options.mapFile, objects, layout, symbolTable)) {
+                mapWritten = false;
+            }
+            if (!options.jsonMapFile.empty() && !mapFile.writeJSON(options.jsonMapFile, objects, layout, symbolTable)) {
+                mapWritten = false;
+            }
+        });
+    }
+
+    OutputWriter writer;
+    writer.setBuildId(options.buildId);
+    bool written = writer.write(options.outputFile, objects, layout, symbolTable);
+    mapJoiner.join();
 
     std::cout << "Cross-platform linking completed." << std::endl;
+    return written && mapWritten;
 }
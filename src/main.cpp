@@ -1,53 +1,49 @@
-#include "parser.h"
-#include "relocation.h"
 #include "linker.h"
-#include "platform_detector.h"
-#include "symbol_table.h"
+#include "link_server.h"
 #include <iostream>
 #include <vector>
 
 int main(int argc, char** argv) {
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <object file 1> <object file 2> ..." << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [-o <output>] [-Map=<file>] [--json-map=<file>] [--symbol-ordering-file=<file>] [--compress-debug-sections=zlib|zstd|none] [--build-id[=fast|sha1|uuid|none]] [--connect <socket>] <object file 1> <object file 2> ...\n"
+                  << "       " << argv[0] << " --serve <socket>" << std::endl;
         return 1;
     }
 
-    PlatformDetector detector;
-    Parser parser;
-    Relocation relocation;
     Linker linker;
-    SymbolTable symbolTable;
-
-    std::vector<std::string> objectFiles;
-
-    for (int i = 1; i < argc; ++i) {
-        std::string objectFile = argv[i];
-        Platform platform = detector.detectPlatform(objectFile);
-        
-        switch (platform) {
-            case Platform::ELF:
-                std::cout << "ELF format detected in " << objectFile << std::endl;
-                break;
-            case Platform::PE:
-                std::cout << "PE format detected in " << objectFile << std::endl;
-                break;
-            case Platform::MACHO:
-                std::cout << "Mach-O format detected in " << objectFile << std::endl;
-                break;
-            case Platform::COFF:
-                std::cout<< "Coff format detected in " << objectFile<<std::endl;
-                break;
-            default:
-                std::cout << "Unknown format in " << objectFile << std::endl;
-                continue; // Skip to the next file if format is unknown
-        }
+    LinkerOptions options;
+
+    std::vector<std::string> args(argv + 1, argv + argc);
+    std::vector<std::string> inputFiles;
+    if (!parseLinkerArguments(args, options, inputFiles)) {
+        return 1;
+    }
+
+    // Server mode: keep parsed objects warm and link on request
+    if (!options.serveSocket.empty()) {
+        LinkServer server;
+        return server.serve(options.serveSocket) ? 0 : 1;
+    }
 
-        objectFiles.push_back(objectFile);
-        parser.parse(objectFile, symbolTable, platform);  
-        relocation.applyRelocation(objectFile, platform);
+    // Client mode: forward the remaining arguments to a running server
+    if (!options.connectSocket.empty()) {
+        std::vector<std::string> forwarded;
+        for (size_t i = 0; i < args.size(); ++i) {
+            if (args[i] == "--connect") {
+                ++i;
+                continue;
+            }
+            forwarded.push_back(args[i]);
+        }
+        return LinkServer::sendRequest(options.connectSocket, forwarded);
     }
 
-    linker.link(objectFiles);  
+    std::vector<std::string> objectFiles = selectObjectFiles(inputFiles);
+
+    if (!linker.link(objectFiles, options)) {
+        std::cerr << "Linking failed." << std::endl;
+        return 1;
+    }
     std::cout << "Linking completed." << std::endl;
 
     return 0;
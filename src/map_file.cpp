@@ -0,0 +1,148 @@
+#include "map_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <utility>
+
+typedef std::map<std::pair<size_t, size_t>, std::vector<const SymbolInfo*> > SectionSymbols;
+
+// Groups defined symbols by their owning input section, sorted by address
+static SectionSymbols collectSectionSymbols(const SymbolTable& symbolTable) {
+    SectionSymbols result;
+    for (const auto& symbol : symbolTable.getSymbols()) {
+        if (symbol.sectionIndex >= 0) {
+            result[std::make_pair(symbol.objectIndex, static_cast<size_t>(symbol.sectionIndex))].push_back(&symbol);
+        }
+    }
+    for (auto& entry : result) {
+        std::stable_sort(entry.second.begin(), entry.second.end(),
+                         [](const SymbolInfo* a, const SymbolInfo* b) { return a->value < b->value; });
+    }
+    return result;
+}
+
+static std::string jsonEscape(const std::string& value) {
+    std::string escaped;
+    for (char c : value) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    escaped += buffer;
+                } else {
+                    escaped += c;
+                }
+                break;
+        }
+    }
+    return escaped;
+}
+
+static void writeMapLine(std::ofstream& file, uint64_t address, uint64_t size, uint64_t align, const std::string& column, int depth) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%16llx %16llx %5llu ",
+                  static_cast<unsigned long long>(address), static_cast<unsigned long long>(size),
+                  static_cast<unsigned long long>(align));
+    file << buffer << std::string(depth * 8, ' ') << column << "\n";
+}
+
+bool MapFile::writeText(const std::string& mapFile, const std::vector<ObjectFile>& objects,
+                        const Layout& layout, const SymbolTable& symbolTable) {
+    std::ofstream file(mapFile, std::ios::trunc);
+
+    if (!file.is_open()) {
+        std::cerr << "Error opening map file: " << mapFile << std::endl;
+        return false;
+    }
+
+    SectionSymbols sectionSymbols = collectSectionSymbols(symbolTable);
+
+    file << "             VMA             Size Align Out     In      Symbol\n";
+    for (const auto& section : layout.getOutputSections()) {
+        writeMapLine(file, section.addr, section.size, section.addralign, section.name, 0);
+
+        for (const auto& placement : section.inputs) {
+            const ObjectFile& object = objects[placement.objectIndex];
+            const InputSection& input = object.sections[placement.sectionIndex];
+            uint64_t inputAddress = 0;
+            layout.getInputSectionAddress(placement.objectIndex, placement.sectionIndex, inputAddress);
+            writeMapLine(file, inputAddress, input.size, input.addralign, object.path + ":(" + input.name + ")", 1);
+
+            auto it = sectionSymbols.find(std::make_pair(placement.objectIndex, placement.sectionIndex));
+            if (it == sectionSymbols.end()) {
+                continue;
+            }
+            for (const SymbolInfo* symbol : it->second) {
+                writeMapLine(file, layout.getSymbolAddress(*symbol), symbol->size, 0, symbol->name, 2);
+            }
+        }
+    }
+
+    if (file.fail()) {
+        std::cerr << "Error writing map file: " << mapFile << std::endl;
+        return false;
+    }
+    std::cout << "Wrote link map to: " << mapFile << std::endl;
+    return true;
+}
+
+bool MapFile::writeJSON(const std::string& mapFile, const std::vector<ObjectFile>& objects,
+                        const Layout& layout, const SymbolTable& symbolTable) {
+    std::ofstream file(mapFile, std::ios::trunc);
+
+    if (!file.is_open()) {
+        std::cerr << "Error opening map file: " << mapFile << std::endl;
+        return false;
+    }
+
+    SectionSymbols sectionSymbols = collectSectionSymbols(symbolTable);
+    const std::vector<OutputSection>& sections = layout.getOutputSections();
+
+    file << "{\n  \"output_sections\": [";
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const OutputSection& section = sections[i];
+        file << (i ? ",\n" : "\n")
+             << "    {\"name\": \"" << jsonEscape(section.name) << "\", \"address\": " << section.addr
+             << ", \"offset\": " << section.fileOffset << ", \"size\": " << section.size
+             << ", \"align\": " << section.addralign << ", \"inputs\": [";
+
+        for (size_t j = 0; j < section.inputs.size(); ++j) {
+            const SectionPlacement& placement = section.inputs[j];
+            const ObjectFile& object = objects[placement.objectIndex];
+            const InputSection& input = object.sections[placement.sectionIndex];
+            uint64_t inputAddress = 0;
+            layout.getInputSectionAddress(placement.objectIndex, placement.sectionIndex, inputAddress);
+
+            file << (j ? ",\n" : "\n")
+                 << "      {\"file\": \"" << jsonEscape(object.path) << "\", \"section\": \"" << jsonEscape(input.name)
+                 << "\", \"address\": " << inputAddress << ", \"size\": " << input.size << ", \"symbols\": [";
+
+            auto it = sectionSymbols.find(std::make_pair(placement.objectIndex, placement.sectionIndex));
+            if (it != sectionSymbols.end()) {
+                for (size_t k = 0; k < it->second.size(); ++k) {
+                    const SymbolInfo* symbol = it->second[k];
+                    file << (k ? ", " : "")
+                         << "{\"name\": \"" << jsonEscape(symbol->name) << "\", \"address\": "
+                         << layout.getSymbolAddress(*symbol) << ", \"size\": " << symbol->size << "}";
+                }
+            }
+            file << "]}";
+        }
+        file << (section.inputs.empty() ? "]}" : "\n    ]}");
+    }
+    file << (sections.empty() ? "]\n}\n" : "\n  ]\n}\n");
+
+    if (file.fail()) {
+        std::cerr << "Error writing map file: " << mapFile << std::endl;
+        return false;
+    }
+    std::cout << "Wrote JSON link map to: " << mapFile << std::endl;
+    return true;
+}
@@ -0,0 +1,94 @@
+#include "object_cache.h"
+#include <sys/stat.h>
+#include <climits>
+#include <cstdlib>
+#include <utility>
+
+const size_t ObjectCache::MAX_ENTRIES;
+
+// Entries are keyed by canonical path so requests from different working
+// directories share them
+static std::string cacheKey(const std::string& filePath) {
+#ifndef _WIN32
+    char resolved[PATH_MAX];
+    if (realpath(filePath.c_str(), resolved)) {
+        return std::string(resolved);
+    }
+#endif
+    return filePath;
+}
+
+bool ObjectCache::readStamp(const std::string& filePath, FileStamp& stamp) {
+    struct stat st;
+    if (stat(filePath.c_str(), &st) != 0) {
+        return false;
+    }
+    stamp.mtime = static_cast<int64_t>(st.st_mtime);
+#ifdef __linux__
+    stamp.mtimeNsec = static_cast<int64_t>(st.st_mtim.tv_nsec);
+#else
+    stamp.mtimeNsec = 0;
+#endif
+    stamp.size = static_cast<uint64_t>(st.st_size);
+    return true;
+}
+
+const CachedObject* ObjectCache::lookup(const std::string& filePath) {
+    auto it = entries.find(cacheKey(filePath));
+    if (it == entries.end()) {
+        return nullptr;
+    }
+
+    // Drop the entry if the file changed or disappeared since it was parsed
+    FileStamp current;
+    if (!readStamp(filePath, current) || !(current == it->second.stamp)) {
+        entries.erase(it);
+        return nullptr;
+    }
+    it->second.lastUse = ++useCounter;
+    return &it->second;
+}
+
+// The stamp must be taken before the file was read. If the file has changed
+// since then, the parsed contents may not match any single version of it and
+// are not cached.
+void ObjectCache::store(const std::string& filePath, const FileStamp& stamp, const ObjectFile& object,
+                        const std::vector<SymbolInfo>& symbols) {
+    FileStamp current;
+    if (!readStamp(filePath, current) || !(current == stamp)) {
+        return;
+    }
+
+    std::string key = cacheKey(filePath);
+    if (entries.size() >= MAX_ENTRIES && entries.find(key) == entries.end()) {
+        prune();
+        if (entries.size() >= MAX_ENTRIES) {
+            auto oldest = entries.begin();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.lastUse < oldest->second.lastUse) {
+                    oldest = it;
+                }
+            }
+            entries.erase(oldest);
+        }
+    }
+
+    CachedObject entry;
+    entry.stamp = stamp;
+    entry.object = object;
+    entry.symbols = symbols;
+    entry.lastUse = ++useCounter;
+    entries[key] = std::move(entry);
+}
+
+// Keys are canonical paths, so they can be stat()ed directly
+void ObjectCache::prune() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        FileStamp current;
+        if (!readStamp(it->first, current) || !(current == it->second.stamp)) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,216 @@
+#include "output_writer.h"
+#include "elf_structures.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+const char* OutputWriter::BUILD_ID_SECTION = ".note.gnu.build-id";
+
+static uint64_t alignTo(uint64_t value, uint64_t align) {
+    return align > 1 ? (value + align - 1) / align * align : value;
+}
+
+void OutputWriter::setBuildId(BuildIdKind kind) {
+    buildId = kind;
+}
+
+bool OutputWriter::write(const std::string& outputFile, const std::vector<ObjectFile>& objects,
+                         const Layout& layout, const SymbolTable& symbolTable) {
+    if (objects.empty()) {
+        std::cerr << "No input objects to write to: " << outputFile << std::endl;
+        return false;
+    }
+    for (const auto& object : objects) {
+        if (object.platform != Platform::ELF) {
+            std::cerr << "Output image writing is only supported for ELF inputs: " << object.path << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<char> image;
+    buildImage(objects, layout, symbolTable, image);
+    if (buildId != BuildIdKind::NONE && !writeBuildId(layout, image)) {
+        return false;
+    }
+    return writeFile(outputFile, image);
+}
+
+// Lays out an ELF64 executable: headers, one PT_LOAD per allocated output
+// section, section contents, then .shstrtab and the section header table.
+void OutputWriter::buildImage(const std::vector<ObjectFile>& objects, const Layout& layout,
+                              const SymbolTable& symbolTable, std::vector<char>& image) {
+    const std::vector<OutputSection>& sections = layout.getOutputSections();
+
+    // Section header string table
+    std::string shstrtab(1, '\0');
+    std::vector<uint32_t> nameOffsets;
+    for (const auto& section : sections) {
+        nameOffsets.push_back(static_cast<uint32_t>(shstrtab.size()));
+        shstrtab += section.name;
+        shstrtab += '\0';
+    }
+    uint32_t shstrtabName = static_cast<uint32_t>(shstrtab.size());
+    shstrtab += ".shstrtab";
+    shstrtab += '\0';
+
+    uint64_t shstrtabOffset = layout.getImageSize();
+    uint64_t shoff = alignTo(shstrtabOffset + shstrtab.size(), 8);
+    uint16_t shnum = static_cast<uint16_t>(sections.size() + 2);
+    image.assign(shoff + shnum * sizeof(ELFSectionHeader), 0);
+
+    // Entry point: _start if defined, otherwise main
+    uint64_t entry = 0;
+    const SymbolInfo* entrySymbol = symbolTable.findSymbol("_start");
+    if (!entrySymbol) {
+        entrySymbol = symbolTable.findSymbol("main");
+    }
+    if (entrySymbol) {
+        entry = layout.getSymbolAddress(*entrySymbol);
+    }
+
+    // Program headers
+    std::vector<ELFProgramHeader> programHeaders;
+    for (const auto& section : sections) {
+        if (!(section.flags & SHF_ALLOC)) {
+            continue;
+        }
+        ELFProgramHeader phdr;
+        phdr.p_type = PT_LOAD;
+        phdr.p_flags = PF_R;
+        if (section.flags & SHF_WRITE) phdr.p_flags |= PF_W;
+        if (section.flags & SHF_EXECINSTR) phdr.p_flags |= PF_X;
+        phdr.p_offset = section.fileOffset;
+        phdr.p_vaddr = section.addr;
+        phdr.p_paddr = section.addr;
+        phdr.p_filesz = (section.type == SHT_NOBITS) ? 0 : section.size;
+        phdr.p_memsz = section.size;
+        phdr.p_align = Layout::SEGMENT_ALIGN;
+        programHeaders.push_back(phdr);
+
+        if (section.type == SHT_NOTE) {
+            phdr.p_type = PT_NOTE;
+            phdr.p_flags = PF_R;
+            phdr.p_align = section.addralign;
+            programHeaders.push_back(phdr);
+        }
+    }
+
+    ELFHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.e_ident[0] = 0x7F;
+    header.e_ident[1] = 'E';
+    header.e_ident[2] = 'L';
+    header.e_ident[3] = 'F';
+    header.e_ident[4] = 2;  // ELFCLASS64
+    header.e_ident[5] = 1;  // ELFDATA2LSB
+    header.e_ident[6] = 1;  // EV_CURRENT
+    header.e_type = 2;      // ET_EXEC
+    header.e_machine = objects[0].machine;
+    header.e_version = 1;
+    header.e_entry = entry;
+    header.e_phoff = programHeaders.empty() ? 0 : sizeof(ELFHeader);
+    header.e_shoff = shoff;
+    header.e_ehsize = sizeof(ELFHeader);
+    header.e_phentsize = sizeof(ELFProgramHeader);
+    header.e_phnum = static_cast<uint16_t>(programHeaders.size());
+    header.e_shentsize = sizeof(ELFSectionHeader);
+    header.e_shnum = shnum;
+    header.e_shstrndx = static_cast<uint16_t>(shnum - 1);
+
+    std::memcpy(&image[0], &header, sizeof(header));
+    if (!programHeaders.empty()) {
+        std::memcpy(&image[sizeof(ELFHeader)], programHeaders.data(), programHeaders.size() * sizeof(ELFProgramHeader));
+    }
+
+    // Section contents and headers
+    std::vector<ELFSectionHeader> sectionHeaders(shnum);
+    std::memset(sectionHeaders.data(), 0, sectionHeaders.size() * sizeof(ELFSectionHeader));
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const OutputSection& section = sections[i];
+
+        bool isCompressed = (section.flags & SHF_COMPRESSED) != 0;
+        if (isCompressed) {
+            std::memcpy(&image[section.fileOffset], section.compressedData.data(), section.compressedData.size());
+        } else if (section.type != SHT_NOBITS) {
+            for (const auto& placement : section.inputs) {
+                const InputSection& input = objects[placement.objectIndex].sections[placement.sectionIndex];
+                const std::vector<char>& bytes = input.bytes();
+                if (!bytes.empty()) {
+                    std::memcpy(&image[section.fileOffset + placement.offset], bytes.data(), bytes.size());
+                }
+            }
+        }
+
+        ELFSectionHeader& shdr = sectionHeaders[i + 1];
+        shdr.sh_name = nameOffsets[i];
+        shdr.sh_type = section.type;
+        shdr.sh_flags = section.flags & ~static_cast<uint64_t>(SHF_GROUP);  // No groups in the output
+        shdr.sh_addr = section.addr;
+        shdr.sh_offset = section.fileOffset;
+        shdr.sh_size = isCompressed ? section.compressedData.size() : section.size;
+        shdr.sh_addralign = isCompressed ? sizeof(uint64_t) : section.addralign;
+    }
+
+    std::memcpy(&image[shstrtabOffset], shstrtab.data(), shstrtab.size());
+    ELFSectionHeader& shstrtabHeader = sectionHeaders[shnum - 1];
+    shstrtabHeader.sh_name = shstrtabName;
+    shstrtabHeader.sh_type = SHT_STRTAB;
+    shstrtabHeader.sh_offset = shstrtabOffset;
+    shstrtabHeader.sh_size = shstrtab.size();
+    shstrtabHeader.sh_addralign = 1;
+
+    std::memcpy(&image[shoff], sectionHeaders.data(), sectionHeaders.size() * sizeof(ELFSectionHeader));
+}
+
+// The note is laid out with a zeroed descriptor; once every other byte of
+// the image is final, the image is hashed and the descriptor patched in place.
+bool OutputWriter::writeBuildId(const Layout& layout, std::vector<char>& image) {
+    for (const auto& section : layout.getOutputSections()) {
+        if (section.name != BUILD_ID_SECTION) {
+            continue;
+        }
+
+        std::vector<uint8_t> id;
+        BuildIdHasher hasher;
+        hasher.compute(buildId, image.data(), image.size(), id);
+
+        // Only the linker's own note may be patched: check namesz, descsz and type
+        uint32_t noteHeader[3] = {0, 0, 0};
+        if (section.inputs.size() != 1 || section.size != 16 + id.size() ||
+            section.fileOffset + section.size > image.size()) {
+            std::cerr << "Unexpected layout of " << BUILD_ID_SECTION << " section" << std::endl;
+            return false;
+        }
+        std::memcpy(noteHeader, &image[section.fileOffset], sizeof(noteHeader));
+        if (noteHeader[0] != 4 || noteHeader[1] != id.size() || noteHeader[2] != NT_GNU_BUILD_ID) {
+            std::cerr << "Unexpected note header in " << BUILD_ID_SECTION << " section" << std::endl;
+            return false;
+        }
+
+        // Descriptor follows namesz, descsz and type and the "GNU\0" name
+        std::memcpy(&image[section.fileOffset + 16], id.data(), id.size());
+        return true;
+    }
+    std::cerr << "Build ID requested but no " << BUILD_ID_SECTION << " section was laid out" << std::endl;
+    return false;
+}
+
+bool OutputWriter::writeFile(const std::string& outputFile, const std::vector<char>& image) {
+    std::ofstream file(outputFile, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        std::cerr << "Error opening output file: " << outputFile << std::endl;
+        return false;
+    }
+
+    file.write(image.data(), image.size());
+
+    if (file.fail()) {
+        std::cerr << "Error writing output file: " << outputFile << std::endl;
+        return false;
+    }
+
+    std::cout << "Wrote " << image.size() << " bytes to: " << outputFile << std::endl;
+    return true;
+}
@@ -1,6 +1,10 @@
 #include "parser.h"
 #include <iostream>
 #include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <utility>
 #include "coff_structures.h"
 #include "elf_structures.h"
 
@@ -96,3 +100,250 @@ void Parser::parse(const std::string& objectFile, SymbolTable& symbolTable, Plat
 
     symbolTable.addSymbol("example_symbol", 0x1000);
 }
+
+// Reads a NUL-terminated string from a string table without running past its end
+static std::string readTableString(const std::vector<char>& table, size_t offset) {
+    if (offset >= table.size()) {
+        return std::string();
+    }
+    return std::string(&table[offset], strnlen(&table[offset], table.size() - offset));
+}
+
+// Reads every section and defined symbol of an object file so the layout
+// and map stages can see which input section owns which symbol.
+bool Parser::parseObject(const std::string& filePath, Platform platform, size_t objectIndex, ObjectFile& object, SymbolTable& symbolTable) {
+    object.path = filePath;
+    object.platform = platform;
+    object.machine = 0;
+    object.sections.clear();
+
+    switch (platform) {
+        case Platform::ELF:
+            return parseELFObject(filePath, objectIndex, object, symbolTable);
+        case Platform::COFF:
+            return parseCOFFObject(filePath, objectIndex, object, symbolTable);
+        default:
+            std::cerr << "Unsupported format for section parsing in file: " << filePath << std::endl;
+            return false;
+    }
+}
+
+bool Parser::parseELFObject(const std::string& filePath, size_t objectIndex, ObjectFile& object, SymbolTable& symbolTable) {
+    std::ifstream file(filePath, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "Error opening ELF file: " << filePath << std::endl;
+        return false;
+    }
+
+    ELFHeader elfHeader;
+    file.read(reinterpret_cast<char*>(&elfHeader), sizeof(ELFHeader));
+
+    if (file.fail() || elfHeader.e_ident[0] != 0x7F || elfHeader.e_ident[1] != 'E' ||
+        elfHeader.e_ident[2] != 'L' || elfHeader.e_ident[3] != 'F') {
+        std::cerr << "Not a valid ELF file: " << filePath << std::endl;
+        return false;
+    }
+    object.machine = elfHeader.e_machine;
+
+    std::vector<ELFSectionHeader> sectionHeaders(elfHeader.e_shnum);
+    file.seekg(elfHeader.e_shoff, std::ios::beg);
+    file.read(reinterpret_cast<char*>(sectionHeaders.data()), elfHeader.e_shnum * sizeof(ELFSectionHeader));
+
+    if (file.fail()) {
+        std::cerr << "Error reading section headers from file: " << filePath << std::endl;
+        return false;
+    }
+
+    // Load section contents
+    object.sections.resize(sectionHeaders.size());
+    for (size_t i = 0; i < sectionHeaders.size(); ++i) {
+        const ELFSectionHeader& shdr = sectionHeaders[i];
+        InputSection& section = object.sections[i];
+        section.type = shdr.sh_type;
+        section.flags = shdr.sh_flags;
+        section.size = shdr.sh_size;
+        section.addralign = shdr.sh_addralign ? shdr.sh_addralign : 1;
+
+        if (shdr.sh_type != SHT_NOBITS && shdr.sh_type != SHT_NULL && shdr.sh_size > 0) {
+            std::vector<char> contents(shdr.sh_size);
+            file.seekg(shdr.sh_offset, std::ios::beg);
+            file.read(contents.data(), shdr.sh_size);
+            if (file.fail()) {
+                std::cerr << "Error reading section " << i << " from file: " << filePath << std::endl;
+                return false;
+            }
+            section.data = std::make_shared<const std::vector<char> >(std::move(contents));
+        }
+    }
+
+    // Resolve section names through the section header string table
+    if (elfHeader.e_shstrndx < object.sections.size()) {
+        const std::vector<char>& names = object.sections[elfHeader.e_shstrndx].bytes();
+        for (size_t i = 0; i < sectionHeaders.size(); ++i) {
+            if (sectionHeaders[i].sh_name < names.size()) {
+                object.sections[i].name = readTableString(names, sectionHeaders[i].sh_name);
+            }
+        }
+    }
+
+    // Add defined and undefined symbols, remembering the owning section
+    for (size_t i = 0; i < sectionHeaders.size(); ++i) {
+        if (sectionHeaders[i].sh_type != SHT_SYMTAB || sectionHeaders[i].sh_link >= object.sections.size()) {
+            continue;
+        }
+
+        const std::vector<char>& symData = object.sections[i].bytes();
+        const std::vector<char>& strData = object.sections[sectionHeaders[i].sh_link].bytes();
+        size_t count = symData.size() / sizeof(Elf64_Sym);
+
+        for (size_t j = 1; j < count; ++j) {
+            Elf64_Sym sym;
+            std::memcpy(&sym, &symData[j * sizeof(Elf64_Sym)], sizeof(Elf64_Sym));
+
+            uint8_t type = ELF64_ST_TYPE(sym.st_info);
+            if (type == STT_SECTION || type == STT_FILE || sym.st_name >= strData.size()) {
+                continue;
+            }
+
+            SymbolInfo info;
+            info.name = readTableString(strData, sym.st_name);
+            if (info.name.empty()) {
+                continue;
+            }
+            info.objectIndex = objectIndex;
+            // Reserved indices (absolute, common) and out-of-range ones own no section
+            info.sectionIndex = (sym.st_shndx != SHN_UNDEF && sym.st_shndx < SHN_LORESERVE &&
+                                 sym.st_shndx < object.sections.size()) ? sym.st_shndx : -1;
+            info.value = sym.st_value;
+            info.size = sym.st_size;
+            info.isFunction = (type == STT_FUNC);
+            symbolTable.addSymbol(info);
+        }
+    }
+
+    std::cout << "Parsed " << object.sections.size() << " sections from: " << filePath << std::endl;
+    return true;
+}
+
+bool Parser::parseCOFFObject(const std::string& filePath, size_t objectIndex, ObjectFile& object, SymbolTable& symbolTable) {
+    std::ifstream file(filePath, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "Error opening COFF file: " << filePath << std::endl;
+        return false;
+    }
+
+    COFFHeader coffHeader;
+    file.read(reinterpret_cast<char*>(&coffHeader), sizeof(COFFHeader));
+    if (file.fail()) {
+        std::cerr << "Error reading COFF header from file: " << filePath << std::endl;
+        return false;
+    }
+    object.machine = coffHeader.Machine;
+
+    // The string table directly follows the symbol table
+    std::vector<char> stringTable;
+    if (coffHeader.NumberOfSymbols > 0) {
+        uint32_t stringTableSize = 0;
+        file.seekg(coffHeader.PointerToSymbolTable + coffHeader.NumberOfSymbols * sizeof(COFFSymbol), std::ios::beg);
+        file.read(reinterpret_cast<char*>(&stringTableSize), sizeof(stringTableSize));
+        if (!file.fail() && stringTableSize > sizeof(stringTableSize)) {
+            stringTable.resize(stringTableSize, 0);
+            file.read(&stringTable[sizeof(stringTableSize)], stringTableSize - sizeof(stringTableSize));
+        }
+        file.clear();
+    }
+
+    // Load section headers and contents
+    std::vector<COFFSectionHeader> sectionHeaders(coffHeader.NumberOfSections);
+    file.seekg(sizeof(COFFHeader) + coffHeader.SizeOfOptionalHeader, std::ios::beg);
+    file.read(reinterpret_cast<char*>(sectionHeaders.data()), sectionHeaders.size() * sizeof(COFFSectionHeader));
+    if (file.fail()) {
+        std::cerr << "Error reading COFF section headers from file: " << filePath << std::endl;
+        return false;
+    }
+
+    object.sections.resize(sectionHeaders.size());
+    for (size_t i = 0; i < sectionHeaders.size(); ++i) {
+        const COFFSectionHeader& shdr = sectionHeaders[i];
+        InputSection& section = object.sections[i];
+
+        section.name = std::string(shdr.Name, strnlen(shdr.Name, sizeof(shdr.Name)));
+        if (section.name.size() > 1 && section.name[0] == '/') {
+            size_t offset = std::strtoul(section.name.c_str() + 1, nullptr, 10);
+            if (offset < stringTable.size()) {
+                section.name = readTableString(stringTable, offset);
+            }
+        }
+
+        uint32_t alignBits = (shdr.Characteristics >> 20) & 0xF;
+        section.addralign = alignBits ? (1ULL << (alignBits - 1)) : 1;
+        section.size = shdr.SizeOfRawData;
+        section.type = (shdr.Characteristics & 0x80) ? SHT_NOBITS : SHT_PROGBITS;  // IMAGE_SCN_CNT_UNINITIALIZED_DATA
+        section.flags = 0;
+        if (!(shdr.Characteristics & 0x02000800)) {  // IMAGE_SCN_MEM_DISCARDABLE | IMAGE_SCN_LNK_REMOVE
+            section.flags |= SHF_ALLOC;
+        }
+        if (shdr.Characteristics & 0x20000000) {  // IMAGE_SCN_MEM_EXECUTE
+            section.flags |= SHF_EXECINSTR;
+        }
+        if (shdr.Characteristics & 0x80000000) {  // IMAGE_SCN_MEM_WRITE
+            section.flags |= SHF_WRITE;
+        }
+
+        if (section.type != SHT_NOBITS && shdr.SizeOfRawData > 0) {
+            std::vector<char> contents(shdr.SizeOfRawData);
+            file.seekg(shdr.PointerToRawData, std::ios::beg);
+            file.read(contents.data(), shdr.SizeOfRawData);
+            if (file.fail()) {
+                std::cerr << "Error reading COFF section " << section.name << " from file: " << filePath << std::endl;
+                return false;
+            }
+            section.data = std::make_shared<const std::vector<char> >(std::move(contents));
+        }
+    }
+
+    // Add symbols, skipping auxiliary records and section/file definitions
+    file.seekg(coffHeader.PointerToSymbolTable, std::ios::beg);
+    for (uint32_t i = 0; i < coffHeader.NumberOfSymbols; ++i) {
+        COFFSymbol symbol;
+        file.read(reinterpret_cast<char*>(&symbol), sizeof(symbol));
+        if (file.fail()) {
+            break;
+        }
+
+        uint8_t auxCount = symbol.NumberOfAuxSymbols;
+        bool isSectionOrFile = symbol.StorageClass == 103 ||  // IMAGE_SYM_CLASS_FILE
+                               (symbol.StorageClass == 3 && auxCount > 0);  // Section definition
+        if (auxCount > 0) {
+            file.seekg(auxCount * sizeof(COFFSymbol), std::ios::cur);
+            i += auxCount;
+        }
+        if (isSectionOrFile) {
+            continue;
+        }
+
+        SymbolInfo info;
+        if (symbol.Zeroes == 0) {
+            if (symbol.Offset < stringTable.size()) {
+                info.name = readTableString(stringTable, symbol.Offset);
+            }
+        } else {
+            info.name = std::string(symbol.Name, strnlen(symbol.Name, sizeof(symbol.Name)));
+        }
+        if (info.name.empty()) {
+            continue;
+        }
+        info.objectIndex = objectIndex;
+        info.sectionIndex = (symbol.SectionNumber > 0 && symbol.SectionNumber <= static_cast<int>(object.sections.size()))
+                                ? symbol.SectionNumber - 1 : -1;
+        info.value = symbol.Value;
+        info.size = 0;
+        info.isFunction = ((symbol.Type >> 4) == 2);  // IMAGE_SYM_DTYPE_FUNCTION
+        symbolTable.addSymbol(info);
+    }
+
+    std::cout << "Parsed " << object.sections.size() << " sections from: " << filePath << std::endl;
+    return true;
+}
@@ -4,6 +4,14 @@ void SymbolTable::addSymbol(const std::string& name, int address) {
     table[name] = address; 
 }
 
+void SymbolTable::addSymbol(const SymbolInfo& symbol) {
+    if (symbol.sectionIndex >= 0) {
+        definitions[symbol.name].push_back(symbols.size());
+    }
+    symbols.push_back(symbol);
+    table[symbol.name] = static_cast<int>(symbol.value);
+}
+
 int SymbolTable::getAddress(const std::string& name) {
     auto it = table.find(name); 
     if (it != table.end()) {
@@ -11,3 +19,27 @@ int SymbolTable::getAddress(const std::string& name) {
     }
     return -1; 
 }
+
+const SymbolInfo* SymbolTable::findSymbol(const std::string& name) const {
+    auto it = definitions.find(name);
+    if (it != definitions.end()) {
+        return &symbols[it->second.front()];
+    }
+    return nullptr;
+}
+
+// All definitions of a name, including local symbols from different objects
+std::vector<const SymbolInfo*> SymbolTable::findDefinitions(const std::string& name) const {
+    std::vector<const SymbolInfo*> result;
+    auto it = definitions.find(name);
+    if (it != definitions.end()) {
+        for (size_t index : it->second) {
+            result.push_back(&symbols[index]);
+        }
+    }
+    return result;
+}
+
+const std::vector<SymbolInfo>& SymbolTable::getSymbols() const {
+    return symbols;
+}
@@ -0,0 +1,105 @@
+#include "build_id.h"
+#include "parallel.h"
+#include "test_check.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const uint8_t* bytes(const char* text) {
+    return reinterpret_cast<const uint8_t*>(text);
+}
+
+static std::string toHex(const uint8_t* data, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (size_t i = 0; i < size; ++i) {
+        hex += digits[data[i] >> 4];
+        hex += digits[data[i] & 0xF];
+    }
+    return hex;
+}
+
+static std::string sha1Hex(const char* text) {
+    uint8_t digest[20];
+    BuildIdHasher::sha1(bytes(text), std::strlen(text), digest);
+    return toHex(digest, sizeof(digest));
+}
+
+static void testKnownVectors() {
+    CHECK(BuildIdHasher::xxHash64(bytes(""), 0) == 0xEF46DB3751D8E999ULL);
+    CHECK(BuildIdHasher::xxHash64(bytes("abc"), 3) == 0x44BC2CF5AD770999ULL);
+    const char* stripes = "Nobody inspects the spammish repetition";
+    CHECK(BuildIdHasher::xxHash64(bytes(stripes), std::strlen(stripes)) == 0xFBCEA83C8A378BF1ULL);
+
+    CHECK(sha1Hex("") == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    CHECK(sha1Hex("abc") == "a9993e364706816aba3e25717850c26c9cd0d89d");
+    CHECK(sha1Hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+          "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+}
+
+// A single chunk is hashed once as a leaf and once more as the root
+static void testSingleChunkTree() {
+    const char* text = "abc";
+    std::vector<uint8_t> id;
+    BuildIdHasher hasher;
+    hasher.compute(BuildIdKind::SHA1, text, 3, id);
+
+    uint8_t leaf[20];
+    uint8_t root[20];
+    BuildIdHasher::sha1(bytes(text), 3, leaf);
+    BuildIdHasher::sha1(leaf, sizeof(leaf), root);
+    CHECK(id == std::vector<uint8_t>(root, root + sizeof(root)));
+}
+
+static void testThreadCountIndependence(BuildIdKind kind) {
+    std::vector<char> image(BuildIdHasher::CHUNK_SIZE * 5 + 777);
+    uint32_t state = 1;
+    for (auto& byte : image) {
+        state = state * 1664525 + 1013904223;
+        byte = static_cast<char>(state >> 24);
+    }
+
+    BuildIdHasher hasher;
+    std::vector<uint8_t> reference;
+    const size_t threadCounts[] = {1, 2, 3, 8};
+    for (size_t threads : threadCounts) {
+        setParallelThreadCount(threads);
+        std::vector<uint8_t> id;
+        hasher.compute(kind, image.data(), image.size(), id);
+        CHECK(id.size() == BuildIdHasher::hashSize(kind));
+        if (reference.empty()) {
+            reference = id;
+        }
+        CHECK(id == reference);
+    }
+    setParallelThreadCount(0);
+
+    // A change in a later chunk must still change the ID
+    image[BuildIdHasher::CHUNK_SIZE * 4 + 1] ^= 1;
+    std::vector<uint8_t> changed;
+    hasher.compute(kind, image.data(), image.size(), changed);
+    CHECK(changed != reference);
+}
+
+static void testUuid() {
+    BuildIdHasher hasher;
+    std::vector<uint8_t> first;
+    std::vector<uint8_t> second;
+    hasher.compute(BuildIdKind::UUID, "", 0, first);
+    hasher.compute(BuildIdKind::UUID, "", 0, second);
+    CHECK(first.size() == 16);
+    CHECK((first[6] & 0xF0) == 0x40);
+    CHECK((first[8] & 0xC0) == 0x80);
+    CHECK(first != second);
+}
+
+int main() {
+    testKnownVectors();
+    testSingleChunkTree();
+    testThreadCountIndependence(BuildIdKind::FAST);
+    testThreadCountIndependence(BuildIdKind::SHA1);
+    testUuid();
+
+    return testResult("build_id_test");
+}
@@ -0,0 +1,158 @@
+#include "compression.h"
+#include "elf_structures.h"
+#include "layout.h"
+#include "parallel.h"
+#include "test_check.h"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef LINKER_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+// Compressible but not trivial contents spanning several compression chunks
+static std::vector<char> makeContents(size_t size) {
+    std::vector<char> contents(size);
+    uint32_t state = 12345;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 1103515245 + 12345;
+        contents[i] = static_cast<char>('a' + (state >> 16) % 8);
+    }
+    return contents;
+}
+
+static ObjectFile makeObject(const std::string& name, uint64_t flags, const std::vector<char>& contents) {
+    InputSection section;
+    section.name = name;
+    section.type = SHT_PROGBITS;
+    section.flags = flags;
+    section.size = contents.size();
+    section.addralign = 1;
+    section.data = std::make_shared<const std::vector<char> >(contents);
+
+    ObjectFile object;
+    object.path = "test.o";
+    object.platform = Platform::ELF;
+    object.machine = 62;
+    object.sections.push_back(section);
+    return object;
+}
+
+// Compresses one .debug_info output section and returns its Chdr and payload
+static std::vector<char> compressSection(const std::vector<char>& contents, DebugCompression compression) {
+    std::vector<ObjectFile> objects(1, makeObject(".debug_info", 0, contents));
+    Layout layout;
+    layout.assign(objects);
+
+    SectionCompressor compressor;
+    compressor.compressOutputs(objects, layout, compression);
+
+    const OutputSection& section = layout.getOutputSections().at(0);
+    CHECK(section.flags & SHF_COMPRESSED);
+    return section.compressedData;
+}
+
+static bool decompressSection(const std::vector<char>& compressed, std::vector<char>& contents) {
+    std::vector<ObjectFile> objects(1, makeObject(".debug_info", SHF_COMPRESSED, compressed));
+    SectionCompressor compressor;
+    if (!compressor.decompressInputs(objects)) {
+        return false;
+    }
+    contents = objects[0].sections[0].bytes();
+    return true;
+}
+
+static void testRoundTrip(DebugCompression compression, uint32_t chType) {
+    std::vector<char> contents = makeContents(SectionCompressor::CHUNK_SIZE * 3 + 12345);
+
+    // Output must not depend on how many threads compressed the chunks
+    std::vector<char> reference;
+    const size_t threadCounts[] = {1, 2, 3, 8};
+    for (size_t threads : threadCounts) {
+        setParallelThreadCount(threads);
+        std::vector<char> compressed = compressSection(contents, compression);
+        CHECK(compressed.size() > sizeof(Elf64_Chdr));
+        CHECK(compressed.size() < contents.size());
+        if (reference.empty()) {
+            reference = compressed;
+        }
+        CHECK(compressed == reference);
+    }
+    setParallelThreadCount(0);
+
+    Elf64_Chdr header;
+    std::memcpy(&header, reference.data(), sizeof(header));
+    CHECK(header.ch_type == chType);
+    CHECK(header.ch_size == contents.size());
+
+    std::vector<char> decompressed;
+    CHECK(decompressSection(reference, decompressed));
+    CHECK(decompressed == contents);
+}
+
+static void testRejectsBadSize() {
+    std::vector<char> contents = makeContents(100000);
+    std::vector<char> compressed = compressSection(contents, DebugCompression::ZLIB);
+    std::vector<char> decompressed;
+
+    // Implausibly large size must be rejected, not allocated
+    Elf64_Chdr header;
+    std::memcpy(&header, compressed.data(), sizeof(header));
+    header.ch_size = 1ULL << 40;
+    std::memcpy(compressed.data(), &header, sizeof(header));
+    CHECK(!decompressSection(compressed, decompressed));
+
+    // Size that does not match the stream
+    header.ch_size = contents.size() + 1;
+    std::memcpy(compressed.data(), &header, sizeof(header));
+    CHECK(!decompressSection(compressed, decompressed));
+}
+
+#ifdef LINKER_HAVE_ZLIB
+// GNU .zdebug sections are inflated and renamed back to .debug
+static void testGnuZdebug() {
+    std::vector<char> contents = makeContents(SectionCompressor::CHUNK_SIZE + 4321);
+    uLongf streamSize = compressBound(static_cast<uLong>(contents.size()));
+    std::vector<char> compressed(12 + streamSize);
+    CHECK(compress(reinterpret_cast<Bytef*>(&compressed[12]), &streamSize,
+                   reinterpret_cast<const Bytef*>(contents.data()), static_cast<uLong>(contents.size())) == Z_OK);
+    compressed.resize(12 + streamSize);
+    std::memcpy(compressed.data(), "ZLIB", 4);
+    for (size_t i = 0; i < 8; ++i) {
+        compressed[4 + i] = static_cast<char>((static_cast<uint64_t>(contents.size()) >> (56 - i * 8)) & 0xFF);
+    }
+
+    std::vector<ObjectFile> objects(1, makeObject(".zdebug_info", 0, compressed));
+    SectionCompressor compressor;
+    CHECK(compressor.decompressInputs(objects));
+    CHECK(objects[0].sections[0].name == ".debug_info");
+    CHECK(objects[0].sections[0].size == contents.size());
+    CHECK(objects[0].sections[0].bytes() == contents);
+
+    // A .zdebug section without the magic cannot be decoded and fails the link
+    compressed[0] = 'X';
+    objects.assign(1, makeObject(".zdebug_line", 0, compressed));
+    CHECK(!compressor.decompressInputs(objects));
+}
+#endif
+
+int main() {
+#ifdef LINKER_HAVE_ZLIB
+    testRoundTrip(DebugCompression::ZLIB, ELFCOMPRESS_ZLIB);
+    testRejectsBadSize();
+    testGnuZdebug();
+#else
+    std::cout << "zlib not available, skipping zlib tests" << std::endl;
+#endif
+#ifdef LINKER_HAVE_ZSTD
+    testRoundTrip(DebugCompression::ZSTD, ELFCOMPRESS_ZSTD);
+#else
+    std::cout << "zstd not available, skipping zstd tests" << std::endl;
+#endif
+
+    return testResult("compression_test");
+}
@@ -0,0 +1,124 @@
+#include "elf_structures.h"
+#include "layout.h"
+#include "symbol_table.h"
+#include "test_check.h"
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+static void addSection(ObjectFile& object, const std::string& name, uint64_t flags) {
+    InputSection section;
+    section.name = name;
+    section.type = SHT_PROGBITS;
+    section.flags = flags;
+    section.size = 16;
+    section.addralign = 16;
+    section.data = std::make_shared<const std::vector<char> >(16, 0);
+    object.sections.push_back(section);
+}
+
+static void addDefinition(SymbolTable& symbolTable, const std::string& name, size_t objectIndex, int sectionIndex,
+                          bool isFunction) {
+    SymbolInfo symbol;
+    symbol.name = name;
+    symbol.objectIndex = objectIndex;
+    symbol.sectionIndex = sectionIndex;
+    symbol.value = 0;
+    symbol.size = 16;
+    symbol.isFunction = isFunction;
+    symbolTable.addSymbol(symbol);
+}
+
+static std::vector<std::pair<size_t, size_t> > placements(const Layout& layout, const std::string& name) {
+    std::vector<std::pair<size_t, size_t> > result;
+    for (const auto& section : layout.getOutputSections()) {
+        if (section.name == name) {
+            for (const auto& placement : section.inputs) {
+                result.push_back(std::make_pair(placement.objectIndex, placement.sectionIndex));
+            }
+        }
+    }
+    return result;
+}
+
+// Ordered sections come first, then .text.hot, the rest in input order, and .text.unlikely last
+static void testTextOrder() {
+    const uint64_t code = SHF_ALLOC | SHF_EXECINSTR;
+    std::vector<ObjectFile> objects(2);
+    for (auto& object : objects) {
+        object.platform = Platform::ELF;
+        addSection(object, "", 0);  // SHT_NULL slot
+        object.sections[0].type = SHT_NULL;
+    }
+    objects[0].path = "a.o";
+    addSection(objects[0], ".text.cold_path", code);   // 1
+    addSection(objects[0], ".text.hot.loop", code);    // 2
+    addSection(objects[0], ".text.unlikely.err", code);  // 3
+    addSection(objects[0], ".text.dup", code);         // 4
+    addSection(objects[0], ".data.dv", SHF_ALLOC | SHF_WRITE);  // 5
+    addSection(objects[0], ".text.f", code);           // 6
+    objects[1].path = "b.o";
+    addSection(objects[1], ".text.dup", code);         // 1
+    addSection(objects[1], ".text.plain", code);       // 2
+
+    SymbolTable symbolTable;
+    addDefinition(symbolTable, "f", 0, 6, true);
+    addDefinition(symbolTable, "dup", 0, 4, true);  // Static function with the same name in both objects
+    addDefinition(symbolTable, "dup", 1, 1, true);
+    addDefinition(symbolTable, "dv", 0, 5, false);
+
+    std::vector<std::string> order = {"f", "dup", "dv", "missing"};
+
+    std::ostringstream warnings;
+    std::streambuf* previous = std::cerr.rdbuf(warnings.rdbuf());
+    Layout layout;
+    layout.setSymbolOrder(order, symbolTable, objects);
+    std::cerr.rdbuf(previous);
+
+    CHECK(warnings.str().find("not in an executable section: dv") != std::string::npos);
+    CHECK(warnings.str().find("no such symbol: missing") != std::string::npos);
+
+    layout.assign(objects);
+    std::vector<std::pair<size_t, size_t> > expected = {
+        {0, 6}, {0, 4}, {1, 1},  // Ordering file, both definitions of dup
+        {0, 2},                  // .text.hot
+        {0, 1}, {1, 2},          // Everything else, in input order
+        {0, 3},                  // .text.unlikely
+    };
+    CHECK(placements(layout, ".text") == expected);
+
+    // The data symbol's section is not reordered and stays in .data
+    std::vector<std::pair<size_t, size_t> > data = {{0, 5}};
+    CHECK(placements(layout, ".data") == data);
+
+    // Placements are laid out back to back in that order
+    uint64_t first = 0;
+    uint64_t second = 0;
+    CHECK(layout.getInputSectionAddress(0, 6, first));
+    CHECK(layout.getInputSectionAddress(0, 4, second));
+    CHECK(second == first + 16);
+}
+
+// Without an ordering file only the hot/unlikely split applies
+static void testTemperatureOnly() {
+    const uint64_t code = SHF_ALLOC | SHF_EXECINSTR;
+    std::vector<ObjectFile> objects(1);
+    objects[0].platform = Platform::ELF;
+    addSection(objects[0], ".text.unlikely.a", code);  // 0
+    addSection(objects[0], ".text.b", code);           // 1
+    addSection(objects[0], ".text.hot", code);         // 2
+
+    Layout layout;
+    layout.assign(objects);
+    std::vector<std::pair<size_t, size_t> > expected = {{0, 2}, {0, 1}, {0, 0}};
+    CHECK(placements(layout, ".text") == expected);
+}
+
+int main() {
+    testTextOrder();
+    testTemperatureOnly();
+
+    return testResult("layout_test");
+}
@@ -0,0 +1,28 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <iostream>
+
+// Minimal assertions for the test executables: a failed CHECK is reported
+// and counted, and main returns testResult() so ctest sees the failure
+static int failures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition \
+                      << std::endl;                                                   \
+            ++failures;                                                               \
+        }                                                                             \
+    } while (0)
+
+static int testResult(const char* testName) {
+    if (failures) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << testName << " passed" << std::endl;
+    return 0;
+}
+
+#endif // TEST_CHECK_H